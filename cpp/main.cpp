@@ -36,15 +36,18 @@ void run_global_solver(const Config<I>& config) {
 int main() {
     std::signal(SIGINT, signal_handler);
 
+    const std::filesystem::path root_directory = "../../web/static";
+    // next to the build directory, which is recreated on every run, and out of the served web directory
+    const std::filesystem::path cache_directory = "../polyhedron_cache";
     const I one_degree = I::pi() / I(180);
     run_global_solver(Config(
-        Polyhedron(Platonic::cube<I>()),
+        Polyhedron(Platonic::cube<I>(), cache_directory),
         one_degree * I(10),
         one_degree,
         one_degree / I(1000),
         1,
         1,
-        "../../web/static",
+        root_directory,
         "temp"
     ));
 
@@ -2,6 +2,7 @@
 
 #include "box/box.hpp"
 #include "interval/intervals.hpp"
+#include <vector>
 
 namespace Angle {
     template<IntervalType Interval>
@@ -118,3 +119,93 @@ namespace Angle {
         return (horizontal_radius.sqr() + vertical_radius.sqr()).sqrt();
     }
 }
+
+template<IntervalType Interval>
+class AngleSample {
+    Interval angle_;
+    Interval sin_;
+    Interval cos_;
+
+public:
+    explicit AngleSample(const Interval& angle) : angle_(angle), sin_(angle.sin()), cos_(angle.cos()) {}
+
+    const Interval& angle() const {
+        return angle_;
+    }
+
+    const Interval& sin() const {
+        return sin_;
+    }
+
+    const Interval& cos() const {
+        return cos_;
+    }
+};
+
+// min and max enclose the exact end angles, so the box between them covers the exact range, and they only depend on the
+// end itself, so that neighbouring ranges share the same sample at their common end
+template<IntervalType Interval>
+class AngleRange {
+    AngleSample<Interval> value_;
+    AngleSample<Interval> min_;
+    AngleSample<Interval> mid_;
+    AngleSample<Interval> max_;
+
+public:
+    explicit AngleRange(const Range& range) :
+        value_(Angle::angle<Interval>(range)),
+        min_(Angle::angle_min<Interval>(range)),
+        mid_(Angle::angle_mid<Interval>(range)),
+        max_(Angle::angle_max<Interval>(range)) {}
+
+    const AngleSample<Interval>& value() const {
+        return value_;
+    }
+
+    const AngleSample<Interval>& min() const {
+        return min_;
+    }
+
+    const AngleSample<Interval>& mid() const {
+        return mid_;
+    }
+
+    const AngleSample<Interval>& max() const {
+        return max_;
+    }
+};
+
+// Angles of a box evaluated once, so that the predicates do not rebuild them from the range bits for every vertex
+template<IntervalType Interval, size_t Size>
+class AngleBox {
+    Box<Size> box_;
+    std::vector<AngleRange<Interval>> ranges_{};
+    Interval radius_;
+
+public:
+    explicit AngleBox(const Box<Size>& box) : box_(box), radius_(Angle::angle_radius<Interval>(box)) {
+        for(const Range& range: box.ranges) {
+            ranges_.emplace_back(range);
+        }
+    }
+
+    const Box<Size>& box() const {
+        return box_;
+    }
+
+    const AngleRange<Interval>& theta() const {
+        return ranges_[0];
+    }
+
+    const AngleRange<Interval>& phi() const {
+        return ranges_[1];
+    }
+
+    const AngleRange<Interval>& alpha() const requires (Size == 3) {
+        return ranges_[2];
+    }
+
+    const Interval& radius() const {
+        return radius_;
+    }
+};
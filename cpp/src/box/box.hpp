@@ -17,6 +17,14 @@ struct Box {
         });
     }
 
+    size_t depth() const {
+        size_t depth = 0;
+        for(const Range& range: ranges) {
+            depth += range.depth();
+        }
+        return depth;
+    }
+
     bool operator<(const Box& box) const {
         for(size_t i = 0; i < Size; i++) {
             if(ranges.at(i) < box.ranges.at(i)) {
@@ -33,6 +41,15 @@ struct Box {
         return ranges.at(index);
     }
 
+    std::pair<Box, Box> parts(const size_t index) const {
+        const auto [min_range, max_range] = ranges.at(index).parts();
+        Box min_part = *this;
+        Box max_part = *this;
+        min_part.ranges.at(index) = min_range;
+        max_part.ranges.at(index) = max_range;
+        return {min_part, max_part};
+    }
+
     std::vector<Box> parts() const {
         std::array<std::pair<Range, Range>, Size> range_parts;
         for(size_t i = 0; i < Size; i++) {
@@ -34,11 +34,17 @@ public:
         return bits_.size() == range_depth_limit;
     }
 
+    size_t depth() const {
+        return bits_.size();
+    }
+
     std::pair<Range, Range> parts() const {
+        // the new bit is the least significant one, so that the parts are the lower and upper half of this range
         Bitset min_part = bits_;
-        Bitset max_part = bits_;
-        min_part.push_back(false);
-        max_part.push_back(true);
+        min_part.resize(bits_.size() + 1);
+        min_part <<= 1;
+        Bitset max_part = min_part;
+        max_part.set(0);
         return {Range(min_part), Range(max_part)};
     }
 
@@ -78,6 +84,16 @@ public:
         return ostream << "<" << s << ">";
     }
 
+    // ends of the range as numerators over 2^range_depth_limit, so that the common end of neighbouring ranges, and an end
+    // shared with a parent range, have the same key
+    uint32_t min_key() const {
+        return static_cast<uint32_t>(bits_.to_ulong() << (range_depth_limit - bits_.size()));
+    }
+
+    uint32_t max_key() const {
+        return static_cast<uint32_t>((bits_.to_ulong() + 1) << (range_depth_limit - bits_.size()));
+    }
+
     uint32_t pack() const {
         const uint8_t depth = static_cast<uint8_t>(bits_.size());
         const uint32_t bits = static_cast<uint32_t>(bits_.to_ulong());
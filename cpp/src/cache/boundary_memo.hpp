@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <functional>
+
+// A test of one vertex against one boundary element of a box: theta and phi are the keys of the ends of the element, or
+// the packed range it spans, marked by the most significant bit
+struct BoundaryKey {
+    uint32_t vertex;
+    uint32_t theta;
+    uint32_t phi;
+
+    static constexpr uint32_t range_flag = uint32_t{1} << 31;
+
+    static BoundaryKey corner(const size_t vertex, const uint32_t theta_key, const uint32_t phi_key) {
+        return BoundaryKey{static_cast<uint32_t>(vertex), theta_key, phi_key};
+    }
+
+    static BoundaryKey fixed_theta(const size_t vertex, const uint32_t theta_key, const uint32_t phi_pack) {
+        return BoundaryKey{static_cast<uint32_t>(vertex), theta_key, phi_pack | range_flag};
+    }
+
+    static BoundaryKey fixed_phi(const size_t vertex, const uint32_t theta_pack, const uint32_t phi_key) {
+        return BoundaryKey{static_cast<uint32_t>(vertex), theta_pack | range_flag, phi_key};
+    }
+
+    bool operator==(const BoundaryKey& other) const = default;
+};
+
+template<>
+struct std::hash<BoundaryKey> {
+    size_t operator()(const BoundaryKey& key) const {
+        return std::hash<uint64_t>{}((uint64_t{key.theta} << 32 | key.phi) ^ uint64_t{key.vertex} * 0x9e3779b97f4a7c15);
+    }
+};
+
+// Results of the boundary tests of one search over plug boxes, which is confined to a single thread. Neighbouring plug
+// boxes share corners and edges, so each of them is tested once. The memo is cleared once it is full.
+class BoundaryMemo {
+    std::unordered_map<BoundaryKey, bool> results_{};
+    size_t capacity_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+
+public:
+    explicit BoundaryMemo(const size_t capacity) : capacity_(capacity) {}
+
+    std::optional<bool> get(const BoundaryKey& key) const {
+        const auto iterator = results_.find(key);
+        if(iterator == results_.end()) {
+            return std::nullopt;
+        }
+        return iterator->second;
+    }
+
+    template<typename Compute>
+    bool get_or_compute(const BoundaryKey& key, Compute compute) {
+        if(const std::optional<bool> result = get(key)) {
+            hits_++;
+            return result.value();
+        }
+        misses_++;
+        const bool result = compute();
+        if(results_.size() >= capacity_) {
+            results_.clear();
+        }
+        results_.emplace(key, result);
+        return result;
+    }
+
+    size_t hits() const {
+        return hits_;
+    }
+
+    size_t misses() const {
+        return misses_;
+    }
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+
+// Size-bounded key-value cache shared between threads. Keys are spread over independently locked shards, and every
+// shard evicts its oldest entry once it is full. Hash picks the shard as well as the bucket within it.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentCache {
+    static constexpr size_t shard_count = 16;
+
+    struct Shard {
+        std::mutex mutex{};
+        std::unordered_map<Key, Value, Hash> values{};
+        std::deque<Key> keys{};
+    };
+
+    std::array<Shard, shard_count> shards_{};
+    size_t shard_capacity_;
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    Shard& shard(const Key& key) {
+        return shards_[Hash{}(key) % shard_count];
+    }
+
+public:
+    explicit ConcurrentCache(const size_t capacity) : shard_capacity_(std::max(capacity / shard_count, size_t{1})) {}
+
+    ~ConcurrentCache() = default;
+
+    ConcurrentCache(const ConcurrentCache& cache) = delete;
+
+    ConcurrentCache(ConcurrentCache&& cache) = delete;
+
+    ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+    ConcurrentCache& operator=(ConcurrentCache&&) = delete;
+
+    std::optional<Value> get(const Key& key) {
+        Shard& key_shard = shard(key);
+        std::lock_guard<std::mutex> lock(key_shard.mutex);
+        const auto iterator = key_shard.values.find(key);
+        if(iterator == key_shard.values.end()) {
+            misses_++;
+            return std::nullopt;
+        }
+        hits_++;
+        return std::make_optional(iterator->second);
+    }
+
+    // keeps the value already cached if another thread stored one first
+    void put(const Key& key, const Value& value) {
+        Shard& key_shard = shard(key);
+        std::lock_guard<std::mutex> lock(key_shard.mutex);
+        if(!key_shard.values.emplace(key, value).second) {
+            return;
+        }
+        key_shard.keys.push_back(key);
+        if(key_shard.keys.size() > shard_capacity_) {
+            key_shard.values.erase(key_shard.keys.front());
+            key_shard.keys.pop_front();
+        }
+    }
+
+    // the value is computed outside the lock, so two threads may compute the same value concurrently
+    template<typename Compute>
+    Value get_or_compute(const Key& key, Compute compute) {
+        if(std::optional<Value> value = get(key)) {
+            return std::move(value.value());
+        }
+        Value value = compute();
+        put(key, value);
+        return value;
+    }
+
+    size_t hits() const {
+        return hits_;
+    }
+
+    size_t misses() const {
+        return misses_;
+    }
+};
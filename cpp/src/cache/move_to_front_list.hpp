@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// The most recently touched values of one search, most recent first. Touching a value moves it to the front, and the
+// least recently touched value is dropped once the list is full.
+template<typename Value>
+class MoveToFrontList {
+    std::vector<Value> values_{};
+    size_t capacity_;
+
+public:
+    explicit MoveToFrontList(const size_t capacity) : capacity_(capacity) {
+        values_.reserve(capacity);
+    }
+
+    void touch(const Value& value) {
+        if(capacity_ == 0) {
+            return;
+        }
+        auto iterator = std::ranges::find(values_, value);
+        if(iterator == values_.end()) {
+            if(values_.size() < capacity_) {
+                values_.push_back(value);
+            }
+            iterator = std::prev(values_.end());
+            *iterator = value;
+        }
+        std::rotate(values_.begin(), iterator, std::next(iterator));
+    }
+
+    const std::vector<Value>& values() const {
+        return values_;
+    }
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Fixed-size table of values that are computed once and never change, shared between threads without locks. A slot is
+// published with a single compare-and-swap, and a thread that loses the race discards its own value for the published
+// one, so readers only ever see complete values. The table owns its values until it is destroyed.
+template<typename Value>
+class PublishedTable {
+    // publishing fills in a value that was determined all along, so it is allowed through a const table
+    mutable std::vector<std::atomic<const Value*>> slots_;
+
+public:
+    explicit PublishedTable(const size_t size) : slots_(size) {}
+
+    ~PublishedTable() {
+        for(std::atomic<const Value*>& slot: slots_) {
+            delete slot.load(std::memory_order_acquire);
+        }
+    }
+
+    PublishedTable(const PublishedTable& table) = delete;
+
+    PublishedTable(PublishedTable&& table) = delete;
+
+    PublishedTable& operator=(const PublishedTable&) = delete;
+
+    PublishedTable& operator=(PublishedTable&&) = delete;
+
+    size_t size() const {
+        return slots_.size();
+    }
+
+    const Value* get(const size_t index) const {
+        return slots_[index].load(std::memory_order_acquire);
+    }
+
+    // the value is computed outside of any lock, so two threads may compute the same value concurrently
+    template<typename Compute>
+    const Value& get_or_publish(const size_t index, Compute compute) const {
+        if(const Value* value = get(index)) {
+            return *value;
+        }
+        std::unique_ptr<const Value> value = compute();
+        const Value* expected = nullptr;
+        if(slots_[index].compare_exchange_strong(expected, value.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return *value.release();
+        }
+        return *expected;
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "geometry/vector3.hpp"
+#include "geometry/normal_mask.hpp"
+#include <array>
+#include <vector>
+#include <optional>
+#include <cmath>
+#include <algorithm>
+
+// Cube map over the unit sphere. Every cell is the cone spanned by its four corners, so a face normal has a certain sign
+// on the whole cell if it has that sign on all four corners.
+template<IntervalType Interval>
+class GaussMap {
+    struct Cell {
+        NormalMask positive{};
+        NormalMask negative{};
+        std::vector<size_t> borderline{};
+    };
+
+    static constexpr int resolution = 16;
+    static constexpr int max_cells = 4;
+
+    std::vector<Cell> cells_{};
+
+    static size_t cell_index(const size_t axis, const bool negative, const int u, const int v) {
+        return static_cast<size_t>((static_cast<int>(axis * 2 + negative) * resolution + u) * resolution + v);
+    }
+
+    static Interval boundary(const int k) {
+        return Interval(2 * k - resolution) / Interval(resolution);
+    }
+
+    static int cell_coordinate(const double value) {
+        return std::clamp(static_cast<int>(std::floor((value + 1) * resolution / 2)), 0, resolution - 1);
+    }
+
+    static const Interval& component(const Vector3<Interval>& vector, const size_t axis) {
+        return axis == 0 ? vector.x() : axis == 1 ? vector.y() : vector.z();
+    }
+
+    static Vector3<Interval> cube_point(const size_t axis, const Interval& w, const Interval& u, const Interval& v) {
+        if(axis == 0) {
+            return Vector3<Interval>(w, u, v);
+        }
+        if(axis == 1) {
+            return Vector3<Interval>(v, w, u);
+        }
+        return Vector3<Interval>(u, v, w);
+    }
+
+public:
+    GaussMap() = default;
+
+    explicit GaussMap(const std::vector<Vector3<Interval>>& normals) : cells_(static_cast<size_t>(6 * resolution * resolution)) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            for(const bool negative: {false, true}) {
+                const Interval w = Interval(negative ? -1 : 1);
+                std::vector<Vector3<Interval>> corners;
+                for(int u = 0; u <= resolution; ++u) {
+                    for(int v = 0; v <= resolution; ++v) {
+                        corners.push_back(cube_point(axis, w, boundary(u), boundary(v)));
+                    }
+                }
+                std::vector<int> signs(corners.size());
+                for(size_t index = 0; index < normals.size(); ++index) {
+                    for(size_t corner = 0; corner < corners.size(); ++corner) {
+                        const Interval dot = corners[corner].dot(normals[index]);
+                        signs[corner] = dot.pos() ? 1 : dot.neg() ? -1 : 0;
+                    }
+                    for(int u = 0; u < resolution; ++u) {
+                        for(int v = 0; v < resolution; ++v) {
+                            const std::array corner_signs = {
+                                signs[static_cast<size_t>(u * (resolution + 1) + v)],
+                                signs[static_cast<size_t>((u + 1) * (resolution + 1) + v)],
+                                signs[static_cast<size_t>(u * (resolution + 1) + v + 1)],
+                                signs[static_cast<size_t>((u + 1) * (resolution + 1) + v + 1)]
+                            };
+                            Cell& cell = cells_[cell_index(axis, negative, u, v)];
+                            if(std::ranges::all_of(corner_signs, [](const int sign) { return sign == 1; })) {
+                                cell.positive.set(index);
+                            } else if(std::ranges::all_of(corner_signs, [](const int sign) { return sign == -1; })) {
+                                cell.negative.set(index);
+                            } else {
+                                cell.borderline.push_back(index);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Returns nullopt if the direction cone is not certainly covered by a few cells of a single cube face
+    std::optional<NormalMask> get_normal_mask(const Vector3<Interval>& direction, const std::vector<Vector3<Interval>>& normals) const {
+        if(cells_.empty()) {
+            return std::nullopt;
+        }
+
+        size_t axis = 0;
+        for(size_t other_axis = 1; other_axis < 3; ++other_axis) {
+            if(std::abs(component(direction, other_axis).to_float()) > std::abs(component(direction, axis).to_float())) {
+                axis = other_axis;
+            }
+        }
+        const Interval& w = component(direction, axis);
+        if(!w.nonz()) {
+            return std::nullopt;
+        }
+        const bool negative = w.neg();
+        const Interval scale = negative ? -w : w;
+        const Interval u = component(direction, (axis + 1) % 3) / scale;
+        const Interval v = component(direction, (axis + 2) % 3) / scale;
+
+        const auto [u_min, u_max] = u.to_floats();
+        const auto [v_min, v_max] = v.to_floats();
+        const int u_begin = cell_coordinate(u_min);
+        const int u_end = cell_coordinate(u_max) + 1;
+        const int v_begin = cell_coordinate(v_min);
+        const int v_end = cell_coordinate(v_max) + 1;
+        if((u_end - u_begin) * (v_end - v_begin) > max_cells) {
+            return std::nullopt;
+        }
+        if(!(boundary(u_begin) < u) || !(u < boundary(u_end)) || !(boundary(v_begin) < v) || !(v < boundary(v_end))) {
+            return std::nullopt;
+        }
+
+        NormalMask normal_mask;
+        if(u_end - u_begin == 1 && v_end - v_begin == 1) {
+            const Cell& cell = cells_[cell_index(axis, negative, u_begin, v_begin)];
+            normal_mask = cell.positive;
+            for(const size_t index: cell.borderline) {
+                const Interval dot = direction.dot(normals[index]);
+                if(dot.pos()) {
+                    normal_mask.set(index);
+                } else if(!dot.neg()) {
+                    normal_mask.reset();
+                    return normal_mask;
+                }
+            }
+            return normal_mask;
+        }
+
+        NormalMask positive = cells_[cell_index(axis, negative, u_begin, v_begin)].positive;
+        NormalMask certain_negative = cells_[cell_index(axis, negative, u_begin, v_begin)].negative;
+        for(int cell_u = u_begin; cell_u < u_end; ++cell_u) {
+            for(int cell_v = v_begin; cell_v < v_end; ++cell_v) {
+                const Cell& cell = cells_[cell_index(axis, negative, cell_u, cell_v)];
+                positive = positive & cell.positive;
+                certain_negative = certain_negative & cell.negative;
+            }
+        }
+        const NormalMask certain = positive | certain_negative;
+        normal_mask = positive;
+        for(size_t index = 0; index < normals.size(); ++index) {
+            if(certain.test(index)) {
+                continue;
+            }
+            const Interval dot = direction.dot(normals[index]);
+            if(dot.pos()) {
+                normal_mask.set(index);
+            } else if(!dot.neg()) {
+                normal_mask.reset();
+                return normal_mask;
+            }
+        }
+        return normal_mask;
+    }
+};
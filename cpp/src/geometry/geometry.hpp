@@ -5,5 +5,7 @@
 #include "geometry/edge.hpp"
 #include "geometry/matrix.hpp"
 #include "geometry/polygon.hpp"
+#include "geometry/normal_mask.hpp"
+#include "geometry/gauss_map.hpp"
 #include "geometry/polyhedron.hpp"
 #include "geometry/polyhedra.hpp"
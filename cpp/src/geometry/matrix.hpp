@@ -88,30 +88,42 @@ public:
                       Interval(0), Interval(0), Interval(-1));
     }
 
-    static Matrix rotation_x(const Interval& angle) {
+    static Matrix rotation_x(const Interval& cos_angle, const Interval& sin_angle) {
         return Matrix(
             Interval(1), Interval(0), Interval(0),
-            Interval(0), angle.cos(), -angle.sin(),
-            Interval(0), angle.sin(), angle.cos()
+            Interval(0), cos_angle, -sin_angle,
+            Interval(0), sin_angle, cos_angle
         );
     }
 
-    static Matrix rotation_y(const Interval& angle) {
+    static Matrix rotation_y(const Interval& cos_angle, const Interval& sin_angle) {
         return Matrix(
-            angle.cos(), Interval(0), angle.sin(),
+            cos_angle, Interval(0), sin_angle,
             Interval(0), Interval(1), Interval(0),
-            -angle.sin(), Interval(0), angle.cos()
+            -sin_angle, Interval(0), cos_angle
         );
     }
 
-    static Matrix rotation_z(const Interval& angle) {
+    static Matrix rotation_z(const Interval& cos_angle, const Interval& sin_angle) {
         return Matrix(
-            angle.cos(), -angle.sin(), Interval(0),
-            angle.sin(), angle.cos(), Interval(0),
+            cos_angle, -sin_angle, Interval(0),
+            sin_angle, cos_angle, Interval(0),
             Interval(0), Interval(0), Interval(1)
         );
     }
 
+    static Matrix rotation_x(const Interval& angle) {
+        return rotation_x(angle.cos(), angle.sin());
+    }
+
+    static Matrix rotation_y(const Interval& angle) {
+        return rotation_y(angle.cos(), angle.sin());
+    }
+
+    static Matrix rotation_z(const Interval& angle) {
+        return rotation_z(angle.cos(), angle.sin());
+    }
+
     static Matrix orientation(const Interval& theta, const Interval& phi) {
         return rotation_x(phi) * rotation_z(theta);
     }
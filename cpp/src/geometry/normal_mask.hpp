@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+class NormalMask {
+    std::array<uint64_t, 2> words_{};
+
+public:
+    static constexpr size_t max_size = 128;
+
+    void set(const size_t index) {
+        words_[index / 64] |= uint64_t{1} << (index % 64);
+    }
+
+    void reset() {
+        words_ = {};
+    }
+
+    bool test(const size_t index) const {
+        return (words_[index / 64] >> (index % 64) & 1) != 0;
+    }
+
+    size_t count() const {
+        return static_cast<size_t>(std::popcount(words_[0]) + std::popcount(words_[1]));
+    }
+
+    bool none() const {
+        return words_[0] == 0 && words_[1] == 0;
+    }
+
+    uint64_t hash() const {
+        uint64_t hash = words_[0] ^ (words_[1] + uint64_t{0x9E3779B97F4A7C15} + (words_[0] << 6) + (words_[0] >> 2));
+        hash ^= hash >> 33;
+        hash *= uint64_t{0xFF51AFD7ED558CCD};
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    NormalMask operator&(const NormalMask& other) const {
+        NormalMask normal_mask;
+        normal_mask.words_ = {words_[0] & other.words_[0], words_[1] & other.words_[1]};
+        return normal_mask;
+    }
+
+    NormalMask operator|(const NormalMask& other) const {
+        NormalMask normal_mask;
+        normal_mask.words_ = {words_[0] | other.words_[0], words_[1] | other.words_[1]};
+        return normal_mask;
+    }
+
+    bool operator==(const NormalMask& other) const = default;
+};
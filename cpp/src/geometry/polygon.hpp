@@ -2,14 +2,229 @@
 
 #include "geometry/edge.hpp"
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <array>
+#include <optional>
 #include <boost/algorithm/string/join.hpp>
 
 template<IntervalType Interval>
 class Polygon {
+    struct SupportingEdge {
+        size_t index;
+        bool mirrored; // the edge stands in for its reflection through the origin as well
+    };
+
+    static constexpr double symmetry_tolerance = 1e-9;
+
+    // directions of the coarse outer polygon, exact and in counterclockwise order, the second half opposite to the first
+    static constexpr std::array<std::pair<int, int>, 8> coarse_directions = {{
+        {1, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 1}, {-1, 2}, {-1, 1}, {-2, 1}
+    }};
+
+    static std::vector<Vector2<Interval>> outward_normals(const std::vector<Edge<Interval>>& edges) {
+        std::vector<Vector2<Interval>> normals;
+        for(const Edge<Interval>& edge: edges) {
+            normals.emplace_back(edge.to().y() - edge.from().y(), edge.from().x() - edge.to().x());
+        }
+        return normals;
+    }
+
+    static std::vector<Interval> lengths(const std::vector<Vector2<Interval>>& vectors) {
+        std::vector<Interval> lengths;
+        for(const Vector2<Interval>& vector: vectors) {
+            lengths.push_back(vector.len());
+        }
+        return lengths;
+    }
+
+    static std::vector<Interval> support_values(const std::vector<Edge<Interval>>& edges, const std::vector<Vector2<Interval>>& normals) {
+        std::vector<Interval> supports;
+        for(size_t i = 0; i < edges.size(); ++i) {
+            supports.push_back(normals[i].dot(edges[i].from()));
+        }
+        return supports;
+    }
+
+    static Interval outer_radius(const std::vector<Edge<Interval>>& edges) {
+        if(edges.empty()) {
+            return Interval(0);
+        }
+        std::vector<Interval> radii;
+        for(const Edge<Interval>& edge: edges) {
+            radii.push_back(edge.from().len().max());
+        }
+        return std::ranges::max_element(radii, [](const Interval& radius, const Interval& other_radius) {
+            return radius < other_radius;
+        })->max();
+    }
+
+    static Interval inner_radius(const std::vector<Vector2<Interval>>& normals, const std::vector<Interval>& supports) {
+        if(normals.empty()) {
+            return Interval(0);
+        }
+        std::vector<Interval> distances;
+        for(size_t i = 0; i < normals.size(); ++i) {
+            distances.push_back((supports[i] / normals[i].len()).min());
+        }
+        const Interval radius = std::ranges::min_element(distances, [](const Interval& distance, const Interval& other_distance) {
+            return distance < other_distance;
+        })->min();
+        return radius.pos() ? radius : Interval(0);
+    }
+
+    static std::vector<Vector2<Interval>> outer_normals() {
+        std::vector<Vector2<Interval>> normals;
+        for(const auto& [x, y]: coarse_directions) {
+            normals.emplace_back(Interval(x), Interval(y));
+        }
+        return normals;
+    }
+
+    static std::vector<Interval> outer_supports(const std::vector<Edge<Interval>>& edges, const std::vector<Vector2<Interval>>& normals) {
+        std::vector<Interval> supports;
+        for(const bool negative: {false, true}) {
+            for(const Vector2<Interval>& normal: normals) {
+                std::vector<Interval> dots;
+                for(const Edge<Interval>& edge: edges) {
+                    dots.push_back((negative ? -normal.dot(edge.from()) : normal.dot(edge.from())).max());
+                }
+                supports.push_back(dots.empty() ? Interval(0) : std::ranges::max_element(dots, [](const Interval& dot, const Interval& other_dot) {
+                    return dot < other_dot;
+                })->max());
+            }
+        }
+        return supports;
+    }
+
+    static bool opposite(const Vector2<Interval>& normal, const Interval& support, const Vector2<Interval>& other_normal, const Interval& other_support) {
+        const double x = normal.x().to_float();
+        const double y = normal.y().to_float();
+        const double other_x = other_normal.x().to_float();
+        const double other_y = other_normal.y().to_float();
+        const double len = std::hypot(x, y);
+        const double other_len = std::hypot(other_x, other_y);
+        return x * other_x + y * other_y < 0 &&
+               std::abs(x * other_y - y * other_x) <= symmetry_tolerance * len * other_len &&
+               std::abs(support.to_float() / len - other_support.to_float() / other_len) <= symmetry_tolerance * std::max(std::abs(support.to_float() / len), 1.0);
+    }
+
+    static std::vector<SupportingEdge> pair_edges(const std::vector<Vector2<Interval>>& normals, const std::vector<Interval>& supports, const bool centrally_symmetric) {
+        std::vector<SupportingEdge> supporting_edges;
+        std::vector<bool> paired(normals.size(), false);
+        for(size_t i = 0; i < normals.size(); ++i) {
+            if(paired[i]) {
+                continue;
+            }
+            bool mirrored = false;
+            for(size_t j = i + 1; centrally_symmetric && j < normals.size(); ++j) {
+                if(!paired[j] && opposite(normals[i], supports[i], normals[j], supports[j])) {
+                    paired[j] = true;
+                    mirrored = true;
+                    break;
+                }
+            }
+            supporting_edges.push_back(SupportingEdge{i, mirrored});
+        }
+        return supporting_edges;
+    }
+
+    struct SupportFunction {
+        // support function of the (convex, counterclockwise) polygon: normals[i].dot(p) <= supports[i] for every p inside
+        std::vector<Vector2<Interval>> normals;
+        std::vector<Interval> normal_lengths;
+        std::vector<Interval> supports;
+        Interval circumradius;
+        Interval inradius;
+
+        // For a polygon enclosing a centrally symmetric region, the reflection of an enclosing half plane is enclosing
+        // too, so of two edges with opposite normals only one is tested, together with its reflection
+        std::vector<SupportingEdge> supporting_edges;
+
+        // Outer polygon with 16 edges of fixed directions containing the whole polygon: coarse_normals[j].dot(p) lies
+        // within [-coarse_supports[j + 8], coarse_supports[j]] for every p inside, so few edges decide most points far
+        // outside
+        std::vector<Vector2<Interval>> coarse_normals;
+        std::vector<Interval> coarse_normal_lengths;
+        std::vector<Interval> coarse_supports;
+
+        explicit SupportFunction(const std::vector<Edge<Interval>>& edges, const bool centrally_symmetric) :
+            normals(outward_normals(edges)),
+            normal_lengths(lengths(normals)),
+            supports(support_values(edges, normals)),
+            circumradius(outer_radius(edges)),
+            inradius(inner_radius(normals, supports)),
+            supporting_edges(pair_edges(normals, supports, centrally_symmetric)),
+            coarse_normals(outer_normals()),
+            coarse_normal_lengths(lengths(coarse_normals)),
+            coarse_supports(outer_supports(edges, coarse_normals)) {}
+
+        bool beyond_coarse_support(const Vector2<Interval>& vector) const {
+            for(size_t j = 0; j < coarse_directions.size(); ++j) {
+                const Interval dot = coarse_normals[j].dot(vector);
+                if(coarse_supports[j] < dot || dot < -coarse_supports[j + coarse_directions.size()]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool beyond_coarse_support(const Vector2<Interval>& vector, const Interval& margin) const {
+            for(size_t j = 0; j < coarse_directions.size(); ++j) {
+                const Interval dot = coarse_normals[j].dot(vector);
+                const Interval scaled_margin = margin * coarse_normal_lengths[j];
+                if(coarse_supports[j] + scaled_margin < dot || dot < -(coarse_supports[j + coarse_directions.size()] + scaled_margin)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool beyond_support(const Vector2<Interval>& vector) const {
+            if(circumradius < vector.len() || beyond_coarse_support(vector)) {
+                return true;
+            }
+            return std::ranges::any_of(supporting_edges, [&](const SupportingEdge& edge) {
+                const Interval dot = normals[edge.index].dot(vector);
+                return supports[edge.index] < dot || (edge.mirrored && dot < -supports[edge.index]);
+            });
+        }
+
+        bool beyond_support(const Vector2<Interval>& vector, const Interval& margin) const {
+            if(circumradius + margin < vector.len() || beyond_coarse_support(vector, margin)) {
+                return true;
+            }
+            return std::ranges::any_of(supporting_edges, [&](const SupportingEdge& edge) {
+                const Interval dot = normals[edge.index].dot(vector);
+                const Interval support = supports[edge.index] + margin * normal_lengths[edge.index];
+                return support < dot || (edge.mirrored && dot < -support);
+            });
+        }
+    };
+
     std::vector<Edge<Interval>> edges_;
+    bool centrally_symmetric_;
+
+    // Polygons enclosing a centrally symmetric region are the projected holes, which are tested against many points, so
+    // they build their support function up front. The other polygons, hulls kept for their corners and hole samples
+    // tested against a few points through their edges, build it only when queried.
+    std::optional<SupportFunction> support_function_;
+
+    template<typename Query>
+    auto query_support_function(const Query& query) const {
+        if(support_function_.has_value()) {
+            return query(support_function_.value());
+        }
+        return query(SupportFunction(edges_, centrally_symmetric_));
+    }
 
 public:
-    explicit Polygon(const std::vector<Edge<Interval>>& edges) : edges_(edges) {}
+    // centrally_symmetric promises that the region enclosed by the polygon is symmetric about the origin, the polygon
+    // itself may be slightly asymmetric
+    explicit Polygon(const std::vector<Edge<Interval>>& edges, const bool centrally_symmetric = false) :
+        edges_(edges),
+        centrally_symmetric_(centrally_symmetric),
+        support_function_(centrally_symmetric ? std::make_optional<SupportFunction>(edges_, true) : std::nullopt) {}
 
     ~Polygon() = default;
 
@@ -25,19 +240,79 @@ public:
         return edges_;
     }
 
+    // radius of a circle around the origin containing the polygon
+    Interval circumradius() const {
+        return query_support_function([](const SupportFunction& support_function) {
+            return support_function.circumradius;
+        });
+    }
+
+    // radius of a circle around the origin contained in the polygon, zero if the origin is not certainly inside
+    Interval inradius() const {
+        return query_support_function([](const SupportFunction& support_function) {
+            return support_function.inradius;
+        });
+    }
+
+    bool centrally_symmetric() const {
+        return centrally_symmetric_;
+    }
+
+    // Certain if the vector lies strictly beyond a supporting line of the coarse outer polygon
+    bool beyond_coarse_support(const Vector2<Interval>& vector) const {
+        return query_support_function([&](const SupportFunction& support_function) {
+            return support_function.beyond_coarse_support(vector);
+        });
+    }
+
+    // Certain if the vector lies beyond a supporting line of the coarse outer polygon by more than margin
+    bool beyond_coarse_support(const Vector2<Interval>& vector, const Interval& margin) const {
+        return query_support_function([&](const SupportFunction& support_function) {
+            return support_function.beyond_coarse_support(vector, margin);
+        });
+    }
+
+    // Certain if the vector lies outside the circumscribed circle or strictly beyond the supporting line of an edge
+    bool beyond_support(const Vector2<Interval>& vector) const {
+        return query_support_function([&](const SupportFunction& support_function) {
+            return support_function.beyond_support(vector);
+        });
+    }
+
+    // Certain if the vector lies outside the circumscribed circle or beyond the supporting line of an edge by more than margin
+    bool beyond_support(const Vector2<Interval>& vector, const Interval& margin) const {
+        return query_support_function([&](const SupportFunction& support_function) {
+            return support_function.beyond_support(vector, margin);
+        });
+    }
+
     bool avoids_edges(const Vector2<Interval>& vector) const {
         return std::ranges::all_of(edges_, [&](const Edge<Interval>& edge) {
             return edge.avoids(vector);
         });
     }
 
+    // The reflection of a half plane encloses the symmetric region but not the polygon itself, so unlike the outside tests,
+    // a point is only inside if it is inside the half planes of all edges
     bool inside(const Vector2<Interval>& vector) const {
+        if(centrally_symmetric_) {
+            const SupportFunction& support_function = support_function_.value();
+            for(size_t i = 0; i < support_function.normals.size(); ++i) {
+                if(!(support_function.normals[i].dot(vector) < support_function.supports[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
         return avoids_edges(vector) && std::ranges::all_of(edges_, [&](const Edge<Interval>& edge) {
             return edge.side(vector) != Side::right;
         });
     }
 
     bool outside(const Vector2<Interval>& vector) const {
+        if(centrally_symmetric_) {
+            return support_function_.value().beyond_support(vector);
+        }
         return avoids_edges(vector) && std::ranges::any_of(edges_, [&](const Edge<Interval>& edge) {
             return edge.side(vector) == Side::right;
         });
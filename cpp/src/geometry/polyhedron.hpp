@@ -2,61 +2,152 @@
 
 #include "geometry/vector3.hpp"
 #include "geometry/matrix.hpp"
+#include "geometry/normal_mask.hpp"
+#include "geometry/gauss_map.hpp"
+#include "geometry/polyhedron_cache.hpp"
 #include <vector>
 #include <set>
 #include <map>
-#include <boost/dynamic_bitset.hpp>
+#include <numeric>
+#include <unordered_map>
+#include <optional>
+#include <cmath>
+#include <typeinfo>
+#include <filesystem>
 #include <boost/algorithm/string/join.hpp>
 
-using Bitset = boost::dynamic_bitset<>;
-
 struct Outline {
-    Bitset normal_mask;
+    NormalMask normal_mask;
     std::vector<size_t> vertex_indices;
 
-    bool same_vertex_indices(const std::vector<size_t>& other_vertex_indices) const {
-        if(vertex_indices.size() != other_vertex_indices.size()) {
-            return false;
-        }
-        const size_t size = vertex_indices.size();
-        for(size_t offset = 0; offset < size; ++offset) {
-            bool same = true;
-            for(size_t index = 0; index < size; ++index) {
-                if(vertex_indices[index] != other_vertex_indices[(index + offset) % size]) {
-                    same = false;
-                    break;
-                }
-            }
-            if(same) {
-                return true;
-            }
-        }
-        return false;
+    static std::vector<size_t> canonical_vertex_indices(const std::vector<size_t>& vertex_indices) {
+        std::vector<size_t> canonical = vertex_indices;
+        std::ranges::rotate(canonical, std::ranges::min_element(canonical));
+        return canonical;
     }
 };
 
 template<IntervalType Interval>
 class Polyhedron {
     std::vector<Vector3<Interval>> vertices_;
+    std::vector<size_t> antipodes_{};
 
     std::vector<Vector3<Interval>> face_normals_{};
     std::vector<std::vector<size_t>> faces_{};
+    GaussMap<Interval> gauss_map_{};
 
     std::vector<Outline> outlines_{};
+    std::vector<size_t> outline_slots_{};
 
     std::vector<Matrix<Interval>> rotations_{};
     std::vector<Matrix<Interval>> reflections_{};
 
+    std::vector<std::vector<size_t>> rotation_permutations_{};
+    std::vector<std::vector<size_t>> reflection_permutations_{};
+
     std::vector<std::vector<size_t>> outline_rotations_{};
     std::vector<std::vector<size_t>> outline_reflections_{};
 
+    static constexpr double signature_tolerance = 1e-9;
+    static constexpr double min_vertex_cell_size = 1e-9;
+
+    std::vector<double> vertex_norms_{};
+    std::vector<std::vector<double>> vertex_distances_{};
+
+    double vertex_cell_size_{};
+    std::unordered_multimap<uint64_t, size_t> vertex_cells_{};
+
+    static double float_dist(const Vector3<Interval>& vector, const Vector3<Interval>& other_vector) {
+        const double x = vector.x().to_float() - other_vector.x().to_float();
+        const double y = vector.y().to_float() - other_vector.y().to_float();
+        const double z = vector.z().to_float() - other_vector.z().to_float();
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    static uint64_t vertex_cell_key(const int64_t x, const int64_t y, const int64_t z) {
+        uint64_t key = static_cast<uint64_t>(x) * uint64_t{0x9E3779B97F4A7C15};
+        key ^= static_cast<uint64_t>(y) * uint64_t{0xC2B2AE3D27D4EB4F} + (key << 6) + (key >> 2);
+        key ^= static_cast<uint64_t>(z) * uint64_t{0x165667B19E3779F9} + (key << 6) + (key >> 2);
+        return key;
+    }
+
+    int64_t vertex_cell(const Interval& coordinate) const {
+        return static_cast<int64_t>(std::floor(coordinate.to_float() / vertex_cell_size_));
+    }
+
+    void setup_vertex_lookup() {
+        vertex_norms_.clear();
+        vertex_distances_.clear();
+        vertex_cells_.clear();
+
+        double min_dist = std::numeric_limits<double>::infinity();
+        for(size_t index = 0; index < vertices_.size(); ++index) {
+            vertex_norms_.push_back(vertices_[index].len().to_float());
+            std::vector<double> distances;
+            for(size_t other_index = 0; other_index < vertices_.size(); ++other_index) {
+                if(other_index != index) {
+                    distances.push_back(float_dist(vertices_[index], vertices_[other_index]));
+                }
+            }
+            std::ranges::sort(distances);
+            if(!distances.empty()) {
+                min_dist = std::min(min_dist, distances.front());
+            }
+            vertex_distances_.push_back(distances);
+        }
+
+        if(min_dist == 0) {
+            throw std::runtime_error("Polyhedron has coinciding vertices");
+        }
+        // the floor keeps the cells of nearly coinciding vertices within range of int64_t
+        vertex_cell_size_ = std::max(min_dist / 2, min_vertex_cell_size);
+        for(size_t index = 0; index < vertices_.size(); ++index) {
+            const Vector3<Interval>& vertex = vertices_[index];
+            vertex_cells_.emplace(vertex_cell_key(vertex_cell(vertex.x()), vertex_cell(vertex.y()), vertex_cell(vertex.z())), index);
+        }
+    }
+
+    bool same_signature(const size_t index, const size_t other_index) const {
+        if(std::abs(vertex_norms_[index] - vertex_norms_[other_index]) > signature_tolerance) {
+            return false;
+        }
+        const std::vector<double>& distances = vertex_distances_[index];
+        const std::vector<double>& other_distances = vertex_distances_[other_index];
+        for(size_t i = 0; i < distances.size(); ++i) {
+            if(std::abs(distances[i] - other_distances[i]) > signature_tolerance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::optional<size_t> find_vertex(const Vector3<Interval>& vector) const {
+        const int64_t x = vertex_cell(vector.x());
+        const int64_t y = vertex_cell(vector.y());
+        const int64_t z = vertex_cell(vector.z());
+        for(int64_t dx = -1; dx <= 1; ++dx) {
+            for(int64_t dy = -1; dy <= 1; ++dy) {
+                for(int64_t dz = -1; dz <= 1; ++dz) {
+                    const auto [begin, end] = vertex_cells_.equal_range(vertex_cell_key(x + dx, y + dy, z + dz));
+                    for(auto iterator = begin; iterator != end; ++iterator) {
+                        if(!vector.diff(vertices_[iterator->second])) {
+                            return iterator->second;
+                        }
+                    }
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
     void check_centrally_symmetric() {
-        if(!std::ranges::all_of(vertices_, [&](const Vector3<Interval>& vertex) {
-            return std::ranges::any_of(vertices_, [&](const Vector3<Interval>& other_vertex) {
-                return !other_vertex.diff(-vertex);
-            });
-        })) {
-            throw std::runtime_error("Polyhedron is not centrally symmetric");
+        antipodes_.clear();
+        for(const Vector3<Interval>& vertex: vertices_) {
+            const std::optional<size_t> antipode = find_vertex(-vertex);
+            if(!antipode.has_value()) {
+                throw std::runtime_error("Polyhedron is not centrally symmetric");
+            }
+            antipodes_.push_back(antipode.value());
         }
     }
 
@@ -160,11 +251,19 @@ class Polyhedron {
 
         std::cout << "Found " << face_normals_.size() << " faces" << std::endl;
         std::cout << face_sizes_string << std::endl;
+
+        check_face_count(faces_.size());
     }
 
-    void setup_outlines() {
-        outlines_.clear();
+    static void check_face_count(const size_t face_count) {
+        if(face_count > NormalMask::max_size) {
+            throw std::runtime_error("Polyhedron has more than " + std::to_string(NormalMask::max_size) + " faces");
+        }
+    }
 
+    // normal masks of all outlines, in the order they are found, each with a direction it is seen from
+    std::vector<std::pair<NormalMask, Vector3<Interval>>> find_outline_directions() const {
+        std::vector<std::pair<NormalMask, Vector3<Interval>>> outline_directions;
         for(size_t index_0 = 0; index_0 < face_normals_.size(); ++index_0) {
             for(size_t index_1 = 0; index_1 < face_normals_.size(); ++index_1) {
                 if(index_0 == index_1) {
@@ -191,60 +290,68 @@ class Polyhedron {
                 const Interval epsilon = cross_product.dot(face_normals_[closest_index.value()]) / Interval(100);
                 const Vector3<Interval> direction = (cross_product + bisector * epsilon).unit();
 
-                Bitset normal_mask = get_normal_mask(direction);
+                const NormalMask normal_mask = get_normal_mask(direction);
                 if(normal_mask.none()) {
                     continue;
                 }
                 if(normal_mask.count() != face_normals_.size() / 2) {
                     continue;
                 }
-                if(std::ranges::any_of(outlines_, [&](const Outline& outline) {
-                    return outline.normal_mask == normal_mask;
+                if(std::ranges::any_of(outline_directions, [&](const auto& outline_direction) {
+                    return outline_direction.first == normal_mask;
                 })) {
                     continue;
                 }
+                outline_directions.emplace_back(normal_mask, direction);
+            }
+        }
+        return outline_directions;
+    }
 
-                std::set<size_t> vertex_indices;
-                for(size_t face_index = 0; face_index < faces_.size(); ++face_index) {
-                    if(!normal_mask.test(face_index)) {
-                        continue;
-                    }
-                    for(const size_t vertex_index: faces_[face_index]) {
-                        for(size_t other_face_index = 0; other_face_index < faces_.size(); ++other_face_index) {
-                            if(!normal_mask.test(other_face_index) && std::ranges::find(faces_[other_face_index], vertex_index) != faces_[other_face_index].end()) {
-                                vertex_indices.insert(vertex_index);
-                                break;
-                            }
+    void setup_outlines() {
+        outlines_.clear();
+
+        for(const auto& [normal_mask, direction]: find_outline_directions()) {
+            std::set<size_t> vertex_indices;
+            for(size_t face_index = 0; face_index < faces_.size(); ++face_index) {
+                if(!normal_mask.test(face_index)) {
+                    continue;
+                }
+                for(const size_t vertex_index: faces_[face_index]) {
+                    for(size_t other_face_index = 0; other_face_index < faces_.size(); ++other_face_index) {
+                        if(!normal_mask.test(other_face_index) && std::ranges::find(faces_[other_face_index], vertex_index) != faces_[other_face_index].end()) {
+                            vertex_indices.insert(vertex_index);
+                            break;
                         }
                     }
                 }
+            }
 
-                std::vector<size_t> outline;
-                const size_t first_index = *std::ranges::min_element(vertex_indices);
-                outline.push_back(first_index);
-                vertex_indices.erase(first_index);
-
-                while(!vertex_indices.empty()) {
-                    const size_t last_index = outline.back();
-                    const Vector3<Interval> projected_last_vertex = (vertices_[last_index] - direction * vertices_[last_index].dot(direction)).unit();
-                    const size_t next_index = *std::ranges::min_element(vertex_indices, [&](const size_t vertex_index_0, const size_t vertex_index_1) {
-                        const Vector3<Interval> projected_vertex_0 = (vertices_[vertex_index_0] - direction * vertices_[vertex_index_0].dot(direction)).unit();
-                        const Vector3<Interval> projected_vertex_1 = (vertices_[vertex_index_1] - direction * vertices_[vertex_index_1].dot(direction)).unit();
-                        const bool angle_0_pos = direction.dot(projected_last_vertex.cross(projected_vertex_0)).pos();
-                        const bool angle_1_pos = direction.dot(projected_last_vertex.cross(projected_vertex_1)).pos();
-                        if(angle_0_pos != angle_1_pos) {
-                            return angle_0_pos;
-                        }
-                        const Interval dot_0 = projected_last_vertex.dot(projected_vertex_0);
-                        const Interval dot_1 = projected_last_vertex.dot(projected_vertex_1);
-                        return angle_0_pos ? dot_0 > dot_1 : dot_0 < dot_1;
-                    });
-                    outline.push_back(next_index);
-                    vertex_indices.erase(next_index);
-                }
+            std::vector<size_t> outline;
+            const size_t first_index = *std::ranges::min_element(vertex_indices);
+            outline.push_back(first_index);
+            vertex_indices.erase(first_index);
 
-                outlines_.push_back(Outline{normal_mask, outline});
+            while(!vertex_indices.empty()) {
+                const size_t last_index = outline.back();
+                const Vector3<Interval> projected_last_vertex = (vertices_[last_index] - direction * vertices_[last_index].dot(direction)).unit();
+                const size_t next_index = *std::ranges::min_element(vertex_indices, [&](const size_t vertex_index_0, const size_t vertex_index_1) {
+                    const Vector3<Interval> projected_vertex_0 = (vertices_[vertex_index_0] - direction * vertices_[vertex_index_0].dot(direction)).unit();
+                    const Vector3<Interval> projected_vertex_1 = (vertices_[vertex_index_1] - direction * vertices_[vertex_index_1].dot(direction)).unit();
+                    const bool angle_0_pos = direction.dot(projected_last_vertex.cross(projected_vertex_0)).pos();
+                    const bool angle_1_pos = direction.dot(projected_last_vertex.cross(projected_vertex_1)).pos();
+                    if(angle_0_pos != angle_1_pos) {
+                        return angle_0_pos;
+                    }
+                    const Interval dot_0 = projected_last_vertex.dot(projected_vertex_0);
+                    const Interval dot_1 = projected_last_vertex.dot(projected_vertex_1);
+                    return angle_0_pos ? dot_0 > dot_1 : dot_0 < dot_1;
+                });
+                outline.push_back(next_index);
+                vertex_indices.erase(next_index);
             }
+
+            outlines_.push_back(Outline{normal_mask, outline});
         }
 
         std::map<size_t, size_t> outline_sizes;
@@ -266,6 +373,21 @@ class Polyhedron {
         std::cout << outline_sizes_string << std::endl;
     }
 
+    void setup_outline_lookup() {
+        size_t slot_count = 1;
+        while(slot_count < 2 * outlines_.size()) {
+            slot_count *= 2;
+        }
+        outline_slots_.assign(slot_count, outlines_.size());
+        for(size_t outline_index = 0; outline_index < outlines_.size(); ++outline_index) {
+            size_t slot = outlines_[outline_index].normal_mask.hash() & (slot_count - 1);
+            while(outline_slots_[slot] != outlines_.size()) {
+                slot = (slot + 1) & (slot_count - 1);
+            }
+            outline_slots_[slot] = outline_index;
+        }
+    }
+
     static Matrix<Interval> orthonormal_basis(const Vector3<Interval>& from, const Vector3<Interval>& to, const bool right_handed) {
         const Vector3<Interval> x_axis = from.unit();
         const Vector3<Interval> y_axis = (to - x_axis * to.dot(x_axis)).unit();
@@ -280,36 +402,57 @@ class Polyhedron {
     void setup_symmetries() {
         rotations_.clear();
         reflections_.clear();
+        rotation_permutations_.clear();
+        reflection_permutations_.clear();
 
-        const Vector3<Interval> from = vertices_[0];
-        const Vector3<Interval> to = vertices_[1].diff(-from) ? vertices_[1] : vertices_[2];
+        const size_t from_index = 0;
+        const size_t to_index = vertices_[1].diff(-vertices_[from_index]) ? 1 : 2;
+        const Vector3<Interval> from = vertices_[from_index];
+        const Vector3<Interval> to = vertices_[to_index];
         const Interval dist = from.dist(to);
         const Matrix<Interval> basis = orthonormal_basis(from, to, true);
+
+        std::vector<size_t> from_image_indices;
+        std::vector<size_t> to_image_indices;
+        for(size_t index = 0; index < vertices_.size(); ++index) {
+            if(same_signature(from_index, index)) {
+                from_image_indices.push_back(index);
+            }
+            if(same_signature(to_index, index)) {
+                to_image_indices.push_back(index);
+            }
+        }
+
+        // a symmetry is determined by the images of from and to, so every accepted pair is a distinct symmetry
         for(const bool right_handed: {true, false}) {
-            for(const auto& from_image: vertices_) {
-                for(const auto& to_image: vertices_) {
-                    if((from_image.dist(to_image) - dist).nonz()) {
+            for(const size_t from_image_index: from_image_indices) {
+                for(const size_t to_image_index: to_image_indices) {
+                    const Vector3<Interval>& from_image = vertices_[from_image_index];
+                    const Vector3<Interval>& to_image = vertices_[to_image_index];
+                    if(from_image_index == to_image_index || (from_image.dist(to_image) - dist).nonz()) {
                         continue;
                     }
                     const Matrix<Interval> image_basis = orthonormal_basis(from_image, to_image, right_handed);
                     const Matrix<Interval> symmetry = Matrix<Interval>::relative_rotation(basis, image_basis);
-                    if(std::ranges::all_of(vertices_, [&](const Vector3<Interval>& vertex) {
-                        const Vector3<Interval> vertex_image = symmetry * vertex;
-                        return std::ranges::any_of(vertices_, [&](const Vector3<Interval>& other_vertex) {
-                            return !vertex_image.diff(other_vertex);
-                        });
-                    })) {
-                        std::vector<Matrix<Interval>>& symmetries = right_handed ? rotations_ : reflections_;
-                        if(std::ranges::all_of(symmetries, [&](const Matrix<Interval>& rotation) {
-                            return Matrix<Interval>::relative_rotation(symmetry, rotation).cos_angle() < Interval(1);
-                        })) {
-                            symmetries.push_back(symmetry);
+                    std::vector<size_t> permutation;
+                    for(const Vector3<Interval>& vertex: vertices_) {
+                        const std::optional<size_t> image_index = find_vertex(symmetry * vertex);
+                        if(!image_index.has_value()) {
+                            break;
                         }
+                        permutation.push_back(image_index.value());
+                    }
+                    if(permutation.size() != vertices_.size()) {
+                        continue;
                     }
+                    (right_handed ? rotations_ : reflections_).push_back(symmetry);
+                    (right_handed ? rotation_permutations_ : reflection_permutations_).push_back(permutation);
                 }
             }
         }
+    }
 
+    void print_symmetries() const {
         std::map<int, size_t> rotation_angles;
         for(const Matrix<Interval>& rotation: rotations_) {
             const Interval cos_angle = rotation.cos_angle();
@@ -336,27 +479,26 @@ class Polyhedron {
         outline_rotations_.clear();
         outline_reflections_.clear();
 
+        std::map<std::vector<size_t>, std::vector<size_t>> outline_indices;
+        for(size_t outline_index = 0; outline_index < outlines_.size(); outline_index++) {
+            outline_indices[Outline::canonical_vertex_indices(outlines_[outline_index].vertex_indices)].push_back(outline_index);
+        }
+
         for(const auto& [normal_mask, vertex_indices]: outlines_) {
             std::set<size_t> rotations;
             std::set<size_t> reflections;
 
             for(const bool right_handed: {true, false}) {
-                const std::vector<Matrix<Interval>>& symmetries = right_handed ? rotations_ : reflections_;
+                const std::vector<std::vector<size_t>>& permutations = right_handed ? rotation_permutations_ : reflection_permutations_;
                 std::set<size_t>& outline_symmetries = right_handed ? rotations : reflections;
-                for(const Matrix<Interval>& symmetry: symmetries) {
+                for(const std::vector<size_t>& permutation: permutations) {
                     std::vector<size_t> transformed_vertex_indices;
                     for(const size_t vertex_index: vertex_indices) {
-                        const Vector3<Interval> rotated_vertex = symmetry * vertices_[vertex_index];
-                        const auto vertex_iterator = std::ranges::find_if(vertices_, [&](const Vector3<Interval>& vertex) {
-                            return !rotated_vertex.diff(vertex);
-                        });
-                        const size_t transformed_vertex_index = std::distance(vertices_.begin(), vertex_iterator);
-                        transformed_vertex_indices.push_back(transformed_vertex_index);
+                        transformed_vertex_indices.push_back(permutation[vertex_index]);
                     }
-                    for(size_t outline_index = 0; outline_index < outlines_.size(); outline_index++) {
-                        if(outlines_[outline_index].same_vertex_indices(transformed_vertex_indices)) {
-                            outline_symmetries.insert(outline_index);
-                        }
+                    const auto iterator = outline_indices.find(Outline::canonical_vertex_indices(transformed_vertex_indices));
+                    if(iterator != outline_indices.end()) {
+                        outline_symmetries.insert(iterator->second.begin(), iterator->second.end());
                     }
                 }
             }
@@ -364,17 +506,347 @@ class Polyhedron {
             outline_rotations_.push_back(std::vector<size_t>(rotations.begin(), rotations.end()));
             outline_reflections_.push_back(std::vector<size_t>(reflections.begin(), reflections.end()));
         }
-
-        std::cout << "Found all outline rotations" << std::endl;
-        std::cout << "Found all outline reflections" << std::endl;
     }
 
     void setup() {
+        setup_vertex_lookup();
         check_centrally_symmetric();
         setup_faces();
+        gauss_map_ = GaussMap<Interval>(face_normals_);
         setup_outlines();
+        setup_outline_lookup();
         setup_symmetries();
+        print_symmetries();
         setup_outline_symmetries();
+        std::cout << "Found all outline rotations" << std::endl;
+        std::cout << "Found all outline reflections" << std::endl;
+    }
+
+    uint64_t cache_key() const {
+        PolyhedronCache::Hasher hasher;
+        hasher.add(std::string(typeid(Interval).name()));
+        for(const Vector3<Interval>& vertex: vertices_) {
+            for(const Interval* coordinate: {&vertex.x(), &vertex.y(), &vertex.z()}) {
+                const auto [min, max] = coordinate->to_floats();
+                hasher.add(min);
+                hasher.add(max);
+            }
+        }
+        return hasher.hash();
+    }
+
+    std::filesystem::path cache_path(const std::filesystem::path& cache_directory) const {
+        std::ostringstream name;
+        name << "polyhedron_" << std::hex << cache_key() << ".bin";
+        return cache_directory / name.str();
+    }
+
+    // directed edges of the faces, each mapped to the face it belongs to
+    std::map<std::pair<size_t, size_t>, size_t> face_edges() const {
+        std::map<std::pair<size_t, size_t>, size_t> edges;
+        for(size_t face_index = 0; face_index < faces_.size(); ++face_index) {
+            const std::vector<size_t>& face = faces_[face_index];
+            for(size_t i = 0; i < face.size(); ++i) {
+                if(!edges.emplace(std::pair(face[i], face[(i + 1) % face.size()]), face_index).second) {
+                    throw std::runtime_error("Cached faces share a directed edge");
+                }
+            }
+        }
+        return edges;
+    }
+
+    // Each face must contain every vertex in its plane with all others strictly behind it, and each edge must be
+    // traversed in reverse by another face, so that the faces close up into the whole boundary of the hull
+    void validate_faces() {
+        for(const std::vector<size_t>& face: faces_) {
+            if(face.size() < 3) {
+                throw std::runtime_error("Cached face has fewer than 3 vertices");
+            }
+            const Vector3<Interval>& vertex_0 = vertices_[face[0]];
+            const Vector3<Interval> normal = (vertices_[face[1]] - vertex_0).cross(vertices_[face[2]] - vertex_0).unit();
+            for(size_t index = 0; index < vertices_.size(); ++index) {
+                if(std::ranges::find(face, index) == face.end() && !normal.dot(vertices_[index] - vertex_0).neg()) {
+                    throw std::runtime_error("Cached face is not a complete supporting plane");
+                }
+            }
+            for(size_t i = 0; i < face.size(); ++i) {
+                const Vector3<Interval>& vertex = vertices_[face[i]];
+                const Vector3<Interval>& next_vertex = vertices_[face[(i + 1) % face.size()]];
+                const Vector3<Interval>& next_next_vertex = vertices_[face[(i + 2) % face.size()]];
+                if(normal.dot(vertex - vertex_0).nonz() || !normal.dot((next_vertex - vertex).cross(next_next_vertex - next_vertex)).pos()) {
+                    throw std::runtime_error("Cached face is not a convex counterclockwise polygon");
+                }
+            }
+            face_normals_.push_back(normal);
+        }
+        const std::map<std::pair<size_t, size_t>, size_t> edges = face_edges();
+        for(const auto& [edge, face_index]: edges) {
+            if(!edges.contains(std::pair(edge.second, edge.first))) {
+                throw std::runtime_error("Cached faces do not close up");
+            }
+        }
+    }
+
+    // Each outline must run along the edges between the faces in front and behind, in the direction of the faces in front,
+    // through every such edge exactly once, so whichever normal mask looks it up, it is the outline seen from there. The
+    // masks must be distinct halves of the faces. Whether any outline is missing is left to the checksum, as a direction
+    // without an outline only takes the slower paths that do without one.
+    void validate_outlines() const {
+        const std::map<std::pair<size_t, size_t>, size_t> edges = face_edges();
+        for(size_t outline_index = 0; outline_index < outlines_.size(); ++outline_index) {
+            const auto& [normal_mask, vertex_indices] = outlines_[outline_index];
+            if(normal_mask.count() != faces_.size() / 2 || find_outline(normal_mask) != outline_index) {
+                throw std::runtime_error("Cached outline does not match the faces");
+            }
+            const size_t boundary_edge_count = std::ranges::count_if(edges, [&](const auto& edge) {
+                return normal_mask.test(edge.second) && !normal_mask.test(edges.at(std::pair(edge.first.second, edge.first.first)));
+            });
+            if(vertex_indices.size() != boundary_edge_count || std::set(vertex_indices.begin(), vertex_indices.end()).size() != vertex_indices.size()) {
+                throw std::runtime_error("Cached outline does not visit every outline vertex once");
+            }
+            for(size_t i = 0; i < vertex_indices.size(); ++i) {
+                const size_t vertex_index = vertex_indices[i];
+                const size_t next_vertex_index = vertex_indices[(i + 1) % vertex_indices.size()];
+                const auto front_edge = edges.find(std::pair(vertex_index, next_vertex_index));
+                const auto back_edge = edges.find(std::pair(next_vertex_index, vertex_index));
+                if(front_edge == edges.end() || back_edge == edges.end() || !normal_mask.test(front_edge->second) || normal_mask.test(back_edge->second)) {
+                    throw std::runtime_error("Cached outline vertex is not on the outline");
+                }
+            }
+        }
+    }
+
+    static std::vector<size_t> compose(const std::vector<size_t>& permutation, const std::vector<size_t>& other_permutation) {
+        std::vector<size_t> composition;
+        for(const size_t index: other_permutation) {
+            composition.push_back(permutation[index]);
+        }
+        return composition;
+    }
+
+    // Each permutation must be realised on every vertex by the isometry that the images of two vertices fix, as in
+    // setup_symmetries, and the rotations must be a group with the reflections as a coset of it on either side, so the
+    // file cannot add a map that is not a symmetry. Whether any symmetry is missing is left to the checksum, as a missing
+    // one only keeps more plug boxes in scope.
+    void validate_symmetries() {
+        const size_t from_index = 0;
+        const size_t to_index = vertices_[1].diff(-vertices_[from_index]) ? 1 : 2;
+        const Matrix<Interval> basis = orthonormal_basis(vertices_[from_index], vertices_[to_index], true);
+        for(const bool right_handed: {true, false}) {
+            for(const std::vector<size_t>& permutation: right_handed ? rotation_permutations_ : reflection_permutations_) {
+                if(permutation.size() != vertices_.size() || std::set(permutation.begin(), permutation.end()).size() != vertices_.size()) {
+                    throw std::runtime_error("Cached symmetry is not a permutation of the vertices");
+                }
+                const Matrix<Interval> image_basis = orthonormal_basis(vertices_[permutation[from_index]], vertices_[permutation[to_index]], right_handed);
+                const Matrix<Interval> symmetry = Matrix<Interval>::relative_rotation(basis, image_basis);
+                for(size_t index = 0; index < vertices_.size(); ++index) {
+                    if((symmetry * vertices_[index]).diff(vertices_[permutation[index]])) {
+                        throw std::runtime_error("Cached symmetry does not map the vertices onto each other");
+                    }
+                }
+                (right_handed ? rotations_ : reflections_).push_back(symmetry);
+            }
+        }
+
+        std::vector<size_t> identity(vertices_.size());
+        std::iota(identity.begin(), identity.end(), size_t{0});
+        const std::set<std::vector<size_t>> rotations(rotation_permutations_.begin(), rotation_permutations_.end());
+        const std::set<std::vector<size_t>> reflections(reflection_permutations_.begin(), reflection_permutations_.end());
+        if(rotations.size() != rotation_permutations_.size() || !rotations.contains(identity)) {
+            throw std::runtime_error("Cached rotations are not a group");
+        }
+        for(const std::vector<size_t>& rotation: rotation_permutations_) {
+            for(const std::vector<size_t>& other_rotation: rotation_permutations_) {
+                if(!rotations.contains(compose(rotation, other_rotation))) {
+                    throw std::runtime_error("Cached rotations are not a group");
+                }
+            }
+        }
+        if(reflections.empty()) {
+            return;
+        }
+        if(reflections.size() != rotations.size()) {
+            throw std::runtime_error("Cached reflections are not a coset of the rotations");
+        }
+        const std::vector<size_t>& reflection = reflection_permutations_.front();
+        for(const std::vector<size_t>& rotation: rotation_permutations_) {
+            if(!reflections.contains(compose(reflection, rotation)) || !reflections.contains(compose(rotation, reflection))) {
+                throw std::runtime_error("Cached reflections are not a coset of the rotations");
+            }
+        }
+    }
+
+    // The outline symmetries of an outline must be the outlines its vertices are mapped onto, as in
+    // setup_outline_symmetries. The rotations are a group, so the outlines of an orbit share their rotations and each
+    // orbit is mapped once, and the reflections of an outline are the rotations of its image under any one reflection.
+    void validate_outline_symmetries() const {
+        std::map<std::vector<size_t>, std::vector<size_t>> outline_indices;
+        for(size_t outline_index = 0; outline_index < outlines_.size(); outline_index++) {
+            outline_indices[Outline::canonical_vertex_indices(outlines_[outline_index].vertex_indices)].push_back(outline_index);
+        }
+        const auto images = [&](const std::vector<size_t>& vertex_indices, const std::vector<std::vector<size_t>>& permutations) {
+            std::set<size_t> image_indices;
+            for(const std::vector<size_t>& permutation: permutations) {
+                const auto iterator = outline_indices.find(Outline::canonical_vertex_indices(compose(permutation, vertex_indices)));
+                if(iterator != outline_indices.end()) {
+                    image_indices.insert(iterator->second.begin(), iterator->second.end());
+                }
+            }
+            return std::vector<size_t>(image_indices.begin(), image_indices.end());
+        };
+
+        std::vector<bool> checked(outlines_.size(), false);
+        for(size_t outline_index = 0; outline_index < outlines_.size(); outline_index++) {
+            if(checked[outline_index]) {
+                continue;
+            }
+            const std::vector<size_t> orbit = images(outlines_[outline_index].vertex_indices, rotation_permutations_);
+            for(const size_t orbit_index: orbit) {
+                if(outline_rotations_[orbit_index] != orbit) {
+                    throw std::runtime_error("Cached outline rotations do not match the rotations");
+                }
+                checked[orbit_index] = true;
+            }
+        }
+
+        for(size_t outline_index = 0; outline_index < outlines_.size(); outline_index++) {
+            if(reflection_permutations_.empty()) {
+                if(!outline_reflections_[outline_index].empty()) {
+                    throw std::runtime_error("Cached outline reflections do not match the reflections");
+                }
+                continue;
+            }
+            const std::vector<size_t> image = compose(reflection_permutations_.front(), outlines_[outline_index].vertex_indices);
+            const auto iterator = outline_indices.find(Outline::canonical_vertex_indices(image));
+            const std::vector<size_t> reflections = iterator != outline_indices.end() ? outline_rotations_[iterator->second.front()] : images(image, rotation_permutations_);
+            if(outline_reflections_[outline_index] != reflections) {
+                throw std::runtime_error("Cached outline reflections do not match the reflections");
+            }
+        }
+    }
+
+    void read_cache(const std::filesystem::path& path) {
+        const PolyhedronCache::MappedFile file(path);
+        PolyhedronCache::Reader reader(file);
+        if(reader.read() != PolyhedronCache::magic || reader.read() != PolyhedronCache::version || reader.read_wide() != cache_key()) {
+            throw std::runtime_error("Polyhedron cache does not match");
+        }
+
+        const size_t face_count = reader.read();
+        check_face_count(face_count);
+        for(size_t i = 0; i < face_count; ++i) {
+            faces_.push_back(reader.read_indices(vertices_.size()));
+        }
+
+        const size_t outline_count = reader.read();
+        for(size_t i = 0; i < outline_count; ++i) {
+            NormalMask normal_mask;
+            for(const size_t face_index: reader.read_indices(face_count)) {
+                normal_mask.set(face_index);
+            }
+            outlines_.push_back(Outline{normal_mask, reader.read_indices(vertices_.size())});
+        }
+
+        for(std::vector<std::vector<size_t>>* permutations: {&rotation_permutations_, &reflection_permutations_}) {
+            const size_t permutation_count = reader.read();
+            for(size_t i = 0; i < permutation_count; ++i) {
+                permutations->push_back(reader.read_indices(vertices_.size()));
+            }
+        }
+        for(std::vector<std::vector<size_t>>* outline_symmetries: {&outline_rotations_, &outline_reflections_}) {
+            for(size_t i = 0; i < outline_count; ++i) {
+                outline_symmetries->push_back(reader.read_indices(outline_count));
+            }
+        }
+
+        const uint64_t checksum = reader.checksum();
+        if(reader.read_wide() != checksum || !reader.finished()) {
+            throw std::runtime_error("Polyhedron cache is corrupted");
+        }
+
+        validate_faces();
+        gauss_map_ = GaussMap<Interval>(face_normals_);
+        setup_outline_lookup();
+        validate_outlines();
+        validate_symmetries();
+        validate_outline_symmetries();
+    }
+
+    void write_cache(const std::filesystem::path& path) const {
+        PolyhedronCache::Writer writer;
+        writer.write(PolyhedronCache::magic);
+        writer.write(PolyhedronCache::version);
+        writer.write_wide(cache_key());
+
+        writer.write(faces_.size());
+        for(const std::vector<size_t>& face: faces_) {
+            writer.write_indices(face);
+        }
+
+        writer.write(outlines_.size());
+        for(const auto& [normal_mask, vertex_indices]: outlines_) {
+            std::vector<size_t> face_indices;
+            for(size_t face_index = 0; face_index < faces_.size(); ++face_index) {
+                if(normal_mask.test(face_index)) {
+                    face_indices.push_back(face_index);
+                }
+            }
+            writer.write_indices(face_indices);
+            writer.write_indices(vertex_indices);
+        }
+
+        for(const std::vector<std::vector<size_t>>* permutations: {&rotation_permutations_, &reflection_permutations_}) {
+            writer.write(permutations->size());
+            for(const std::vector<size_t>& permutation: *permutations) {
+                writer.write_indices(permutation);
+            }
+        }
+        for(const std::vector<std::vector<size_t>>* outline_symmetries: {&outline_rotations_, &outline_reflections_}) {
+            for(const std::vector<size_t>& outline_indices: *outline_symmetries) {
+                writer.write_indices(outline_indices);
+            }
+        }
+
+        writer.save(path);
+    }
+
+    void clear() {
+        face_normals_.clear();
+        faces_.clear();
+        gauss_map_ = GaussMap<Interval>();
+        outlines_.clear();
+        outline_slots_.clear();
+        rotations_.clear();
+        reflections_.clear();
+        rotation_permutations_.clear();
+        reflection_permutations_.clear();
+        outline_rotations_.clear();
+        outline_reflections_.clear();
+    }
+
+    void setup(const std::filesystem::path& cache_directory) {
+        const std::filesystem::path path = cache_path(cache_directory);
+        if(std::filesystem::exists(path)) {
+            try {
+                setup_vertex_lookup();
+                check_centrally_symmetric();
+                read_cache(path);
+                std::cout << "Loaded " << faces_.size() << " faces, " << outlines_.size() << " outlines, " << rotations_.size() << " rotations and " << reflections_.size() << " reflections from " << path.string() << std::endl;
+                return;
+            } catch(const std::runtime_error& error) {
+                std::cout << "Ignoring polyhedron cache: " << error.what() << std::endl;
+                clear();
+            }
+        }
+
+        setup();
+
+        try {
+            std::filesystem::create_directories(cache_directory);
+            write_cache(path);
+        } catch(const std::runtime_error& error) {
+            std::cout << "Failed to write polyhedron cache: " << error.what() << std::endl;
+        }
     }
 
 public:
@@ -382,10 +854,24 @@ public:
         setup();
     }
 
+    Polyhedron(const std::vector<Vector3<Interval>>& vertices, const std::filesystem::path& cache_directory) : vertices_(vertices) {
+        setup(cache_directory);
+    }
+
     const std::vector<Vector3<Interval>>& vertices() const {
         return vertices_;
     }
 
+    // lengths of the vertices in floats
+    const std::vector<double>& vertex_norms() const {
+        return vertex_norms_;
+    }
+
+    // index of the reflection of every vertex through the origin
+    const std::vector<size_t>& antipodes() const {
+        return antipodes_;
+    }
+
     const std::vector<Vector3<Interval>>& face_normals() const {
         return face_normals_;
     }
@@ -406,19 +892,31 @@ public:
         return outlines_;
     }
 
-    Bitset get_normal_mask(const Vector3<Interval>& direction) const {
-        Bitset normal_mask(face_normals_.size());
+    NormalMask get_normal_mask(const Vector3<Interval>& direction) const {
+        const std::optional<NormalMask> indexed_normal_mask = gauss_map_.get_normal_mask(direction, face_normals_);
+        if(indexed_normal_mask.has_value()) {
+            return indexed_normal_mask.value();
+        }
+        NormalMask normal_mask;
         for(size_t index = 0; index < face_normals_.size(); ++index) {
             const Interval dot = direction.dot(face_normals_[index]);
             if(dot.pos()) {
                 normal_mask.set(index);
-            } else if(dot.neg()) {
-                normal_mask.reset(index);
-            } else {
+            } else if(!dot.neg()) {
                 normal_mask.reset();
                 return normal_mask;
             }
         }
         return normal_mask;
     }
+
+    std::optional<size_t> find_outline(const NormalMask& normal_mask) const {
+        const size_t slot_mask = outline_slots_.size() - 1;
+        for(size_t slot = normal_mask.hash() & slot_mask; outline_slots_[slot] != outlines_.size(); slot = (slot + 1) & slot_mask) {
+            if(outlines_[outline_slots_[slot]].normal_mask == normal_mask) {
+                return outline_slots_[slot];
+            }
+        }
+        return std::nullopt;
+    }
 };
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace PolyhedronCache {
+    constexpr uint32_t magic = 0x43505552; // "RUPC"
+    // bumped when the layout changes, the contents are validated on every load anyway
+    constexpr uint32_t version = 3;
+
+    class Hasher {
+        uint64_t hash_{0xCBF29CE484222325};
+
+    public:
+        void add(const void* data, const size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for(size_t i = 0; i < size; ++i) {
+                hash_ ^= bytes[i];
+                hash_ *= uint64_t{0x100000001B3};
+            }
+        }
+
+        void add(const double value) {
+            add(&value, sizeof(value));
+        }
+
+        void add(const std::string& value) {
+            add(value.data(), value.size());
+        }
+
+        uint64_t hash() const {
+            return hash_;
+        }
+    };
+
+    class MappedFile {
+        const unsigned char* data_{nullptr};
+        size_t size_{0};
+
+    public:
+        explicit MappedFile(const std::filesystem::path& path) {
+            const int file_descriptor = open(path.c_str(), O_RDONLY);
+            if(file_descriptor < 0) {
+                throw std::runtime_error("Failed to open " + path.string());
+            }
+            struct stat file_stat{};
+            if(fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size <= 0) {
+                close(file_descriptor);
+                throw std::runtime_error("Failed to stat " + path.string());
+            }
+            size_ = static_cast<size_t>(file_stat.st_size);
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+            close(file_descriptor);
+            if(data == MAP_FAILED) {
+                throw std::runtime_error("Failed to map " + path.string());
+            }
+            data_ = static_cast<const unsigned char*>(data);
+        }
+
+        ~MappedFile() {
+            munmap(const_cast<unsigned char*>(data_), size_);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        const unsigned char* data() const {
+            return data_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+    };
+
+    class Reader {
+        const MappedFile& file_;
+        size_t offset_{0};
+
+    public:
+        explicit Reader(const MappedFile& file) : file_(file) {}
+
+        uint32_t read() {
+            if(offset_ + sizeof(uint32_t) > file_.size()) {
+                throw std::runtime_error("Unexpected end of polyhedron cache");
+            }
+            uint32_t value;
+            std::memcpy(&value, file_.data() + offset_, sizeof(value));
+            offset_ += sizeof(value);
+            return value;
+        }
+
+        uint64_t read_wide() {
+            const uint64_t low = read();
+            const uint64_t high = read();
+            return high << 32 | low;
+        }
+
+        size_t read_index(const size_t limit) {
+            const uint32_t index = read();
+            if(index >= limit) {
+                throw std::runtime_error("Index out of range in polyhedron cache");
+            }
+            return index;
+        }
+
+        std::vector<size_t> read_indices(const size_t limit) {
+            const uint32_t size = read();
+            std::vector<size_t> indices;
+            for(uint32_t i = 0; i < size; ++i) {
+                indices.push_back(read_index(limit));
+            }
+            return indices;
+        }
+
+        uint64_t checksum() const {
+            Hasher hasher;
+            hasher.add(file_.data(), offset_);
+            return hasher.hash();
+        }
+
+        bool finished() const {
+            return offset_ == file_.size();
+        }
+    };
+
+    class Writer {
+        std::vector<uint32_t> words_{};
+
+    public:
+        void write(const size_t value) {
+            words_.push_back(static_cast<uint32_t>(value));
+        }
+
+        void write_wide(const uint64_t value) {
+            words_.push_back(static_cast<uint32_t>(value));
+            words_.push_back(static_cast<uint32_t>(value >> 32));
+        }
+
+        void write_indices(const std::vector<size_t>& indices) {
+            write(indices.size());
+            for(const size_t index: indices) {
+                write(index);
+            }
+        }
+
+        void save(const std::filesystem::path& path) {
+            Hasher hasher;
+            hasher.add(words_.data(), words_.size() * sizeof(uint32_t));
+            write_wide(hasher.hash());
+
+            const std::filesystem::path temporary_path = path.string() + ".tmp";
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()) {
+                throw std::runtime_error("Failed to open " + temporary_path.string());
+            }
+            file.write(reinterpret_cast<const char*>(words_.data()), static_cast<std::streamsize>(words_.size() * sizeof(uint32_t)));
+            file.close();
+            if(file.fail()) {
+                throw std::runtime_error("Failed to write to " + temporary_path.string());
+            }
+            std::filesystem::rename(temporary_path, path);
+        }
+    };
+}
@@ -68,11 +68,11 @@ public:
         return Vector2(x_.hull(vector.x_), y_.hull(vector.y_));
     }
 
-    Interval dot(const Vector2& vector) {
+    Interval dot(const Vector2& vector) const {
         return x_ * vector.x_ + y_ * vector.y_;
     }
 
-    Interval cross(const Vector2& vector) {
+    Interval cross(const Vector2& vector) const {
         return x_ * vector.y_ - y_ * vector.x_;
     }
 
@@ -4,6 +4,12 @@
 #include <regex>
 #include <filesystem>
 
+enum class PlugSearch {
+    breadth_first,
+    depth_first,
+    hybrid // breadth-first until the frontier reaches plug_frontier_limit, depth-first below that
+};
+
 template<IntervalType Interval>
 struct Config {
     //parameters
@@ -22,6 +28,11 @@ struct Config {
     std::filesystem::path root_directory;
     std::string name;
 
+    // search parameters
+    PlugSearch plug_search = PlugSearch::hybrid;
+    size_t plug_frontier_limit = 1 << 16;
+    bool plug_margin_split = false; // halve plug boxes along the angle chosen by the vertex margins instead of quartering them
+
     void validate() const {
         if(epsilon.min().neg()) {
             throw std::runtime_error("Epsilon must be non-negative");
@@ -38,6 +49,9 @@ struct Config {
         if(!std::filesystem::is_directory(root_directory)) {
             throw std::runtime_error(root_directory.string() + " is not a directory");
         }
+        if(plug_search == PlugSearch::hybrid && plug_frontier_limit < 1) {
+            throw std::runtime_error("Plug frontier limit must be at least 1");
+        }
         if(!std::regex_match(name, std::regex("^[a-zA-Z0-9_]+$"))) {
             throw std::runtime_error(name + " is not a valid name (only letters, digits, and underscores are allowed)");
         }
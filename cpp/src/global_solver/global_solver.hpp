@@ -4,8 +4,11 @@
 #include "global_solver/exporter.hpp"
 #include "global_solver/helpers.hpp"
 #include "queue/queues.hpp"
+#include "cache/concurrent_cache.hpp"
+#include "cache/published_table.hpp"
 #include <thread>
 #include <latch>
+#include <memory>
 
 const std::string polyhedron_file_name = "polyhedron.bin";
 const std::string pruned_hole_boxes_file_name = "pruned_hole_boxes.bin";
@@ -19,8 +22,9 @@ HBs, prunedHBs, unprunedHBs = [full], [], []
 for HB in HBs:
     if HB outside base symmetries: continue (redundant)
     prunable, PBs, prunedPBs, unprunedPBs, collect_unpruned = true, [full], [], [], |HB| < threshold
+    project the vertices of HB that may lie on its outline (those of the parent of HB that still may)
 
-    for PB in PBs:
+    for PB in PBs (deepest sample first unless collect_unpruned):
         if PB outside base rotations: continue (redundant)
         if |PB, HB| < threshold: continue (out of scope)
 
@@ -32,7 +36,8 @@ for HB in HBs:
         if PB outside HB: add PB to prunedPBs, continue (pruned)
         if |PB| < threshold: set prunable to false, add PB to unprunedPBs, continue (too small)
 
-        add pieces of PB to PBs
+        add halves of PB outside HB to prunedPBs, shrink PB to the rest (halved)
+        add halves of PB to PBs, split along the angle the vertex furthest outside HB moves most
 
     if prunable: add HB and prunedPBs to prunedHBs, continue (pruned)
     if collect_unpruned: add HB and unprunedPBs to unprunedHBs, continue (too small)
@@ -42,11 +47,32 @@ for HB in HBs:
 export(prunedHBs, unprunedHBs)
 */
 
+struct ScoredBox {
+    double score;
+    Box2 box;
+
+    bool operator<(const ScoredBox& other) const {
+        return score < other.score;
+    }
+};
+
+// the vertices that may lie on the outline of the projection of the hole box, shared by the parts of its parent
+struct HoleTask {
+    Box3 box;
+    std::shared_ptr<const std::vector<size_t>> vertex_indices;
+
+    size_t depth() const {
+        return box.depth();
+    }
+};
+
 template<IntervalType Interval>
 class GlobalSolver {
     const Config<Interval>& config_;
+    const std::vector<size_t> vertex_indices_;
+    const double vertex_radius_;
 
-    ConcurrentPriorityQueue<Box3> hole_boxes_{};
+    ConcurrentBucketQueue<HoleTask> hole_boxes_{};
     std::vector<std::thread> threads_{};
     std::atomic<bool> interrupted_{false};
 
@@ -54,69 +80,266 @@ class GlobalSolver {
     ConcurrentQueue<CombinedBoxes> unpruned_hole_boxes_{};
     std::latch exporter_latch_;
 
-    std::tuple<bool, std::vector<Box2>, std::vector<Box2>> process_plug_boxes(const Box3& hole_box, const bool collect_unpruned_plug_boxes) {
-        const Polygon<Interval> projected_hole = project_polyhedron(config_.polyhedron, hole_box, config_.resolution);
+    std::atomic<size_t> pruned_plug_box_count_{0};
+    std::atomic<size_t> tried_vertex_count_{0};
+
+    // hulls of the projection over theta and phi, keyed by the packed theta and phi ranges, so that alpha siblings
+    // processed by any thread project the polyhedron once
+    ConcurrentCache<uint64_t, std::shared_ptr<const std::vector<Vector2<Interval>>>> theta_phi_hulls_{theta_phi_cache_capacity};
+
+    // enclosures of the plug boxes in the top levels of the plug tree, which the searches of all hole boxes go through,
+    // indexed by the packed theta and phi ranges and filled in by whichever thread first needs them
+    size_t shared_plug_depth_;
+    PublishedTable<PlugBoxEnclosures<Interval>> shared_plug_boxes_;
+
+    static constexpr size_t theta_phi_cache_capacity = 1 << 12;
+    static constexpr size_t max_shared_plug_depth = 6;
+    static constexpr size_t shared_plug_vertex_budget = 1 << 18;
+    static constexpr size_t boundary_memo_capacity = 1 << 16;
+    static constexpr size_t recent_vertex_capacity = 16;
+    static constexpr size_t probe_depth = 4;
+    static constexpr size_t probe_candidates = 4;
+    static constexpr double half_screen_margin = 0.25;
+
+    static constexpr size_t shared_plug_box_count(const size_t depth) {
+        return (2 << depth) * (2 << depth);
+    }
+
+    // The shared plug boxes are kept for the lifetime of the solver with up to one enclosure per vertex each, about 300
+    // bytes, so fewer levels are shared the more vertices the polyhedron has
+    static size_t shared_plug_depth(const size_t vertex_count) {
+        size_t depth = max_shared_plug_depth;
+        while(depth > 0 && shared_plug_box_count(depth) * vertex_count > shared_plug_vertex_budget) {
+            depth--;
+        }
+        return depth;
+    }
+
+    // Plug boxes in the top levels come from the shared table, deeper plug boxes have none
+    const PlugBoxEnclosures<Interval>* shared_plug_box_enclosures(const Box2& plug_box) const {
+        const Range theta_range = Angle::theta_range(plug_box);
+        const Range phi_range = Angle::phi_range(plug_box);
+        if(theta_range.depth() > shared_plug_depth_ || phi_range.depth() > shared_plug_depth_) {
+            return nullptr;
+        }
+        return &shared_plug_boxes_.get_or_publish(size_t{theta_range.pack()} << (shared_plug_depth_ + 1) | phi_range.pack(), [&] {
+            return std::make_unique<const PlugBoxEnclosures<Interval>>(config_.polyhedron, AngleBox<Interval, 2>(plug_box));
+        });
+    }
+
+    // Deeper plug boxes are computed into local, which the caller keeps for as long as it uses them
+    const PlugBoxEnclosures<Interval>& plug_box_enclosures(const Box2& plug_box, std::optional<PlugBoxEnclosures<Interval>>& local) const {
+        if(const PlugBoxEnclosures<Interval>* shared_plug_box = shared_plug_box_enclosures(plug_box)) {
+            return *shared_plug_box;
+        }
+        return local.emplace(config_.polyhedron, AngleBox<Interval, 2>(plug_box));
+    }
+
+    // finds an unpruned plug box on a fixed lattice without searching, using floats to pick the candidates
+    bool probe_unpruned_plug_box(const AngleBox<Interval, 3>& hole_box, const Polygon<Interval>& projected_hole, const std::vector<std::array<double, 3>>& hole_half_planes) {
+        std::vector<ScoredBox> candidates;
+        for(size_t theta_bits = 0; theta_bits < 1 << probe_depth; ++theta_bits) {
+            for(size_t phi_bits = 0; phi_bits < 1 << probe_depth; ++phi_bits) {
+                const Box2 plug_box(std::array{Range(Bitset(probe_depth, theta_bits)), Range(Bitset(probe_depth, phi_bits))});
+                const double depth = plug_box_sample_depth(config_.polyhedron, hole_half_planes, plug_box);
+                if(depth > 0) {
+                    candidates.emplace_back(depth, plug_box);
+                }
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end());
+        for(size_t i = 0; i < std::min(candidates.size(), probe_candidates); ++i) {
+            std::optional<PlugBoxEnclosures<Interval>> local_plug_box;
+            const PlugBoxEnclosures<Interval>& plug_box = plug_box_enclosures(candidates[candidates.size() - 1 - i].box, local_plug_box);
+            if(plug_box_sample_inside_hole_box_sample(config_.polyhedron, hole_box, plug_box)) {
+                std::cout << "Rupert passage found for hole box: " << hole_box.box() << " and plug box: " << plug_box.box() << std::endl;
+                throw std::runtime_error("Rupert passage found");
+            }
+            if(plug_box_sample_inside_hole_box(projected_hole, plug_box.sample_outline_indices(), plug_box) &&
+               !hole_box_close_to_plug_box(config_.polyhedron, hole_box, plug_box.angle_box(), config_.epsilon - hole_box.radius())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // counts the pruned plug boxes and the vertices tried for them
+    bool plug_box_outside(const PlugBoxEnclosures<Interval>& plug_box, const Polygon<Interval>& projected_hole, const std::vector<std::array<double, 3>>& hole_half_planes, MoveToFrontList<size_t>& recent_vertices, BoundaryMemo& memo) {
+        size_t tried_vertices = 0;
+        const std::optional<size_t> vertex = plug_box_outside_vertex(
+            config_.polyhedron,
+            plug_box,
+            projected_hole,
+            hole_half_planes,
+            recent_vertices,
+            memo,
+            tried_vertices
+        );
+        if(!vertex.has_value()) {
+            return false;
+        }
+        pruned_plug_box_count_++;
+        tried_vertex_count_ += tried_vertices;
+        return true;
+    }
+
+    // Only halves whose sample sticks out of the hole in floats by a fraction of the distance the vertices travel within
+    // the half are tested rigorously, so that halves which are unlikely to be outside cost no enclosures
+    std::optional<Box2> drop_outside_plug_halves(const Box2& plug_box, const Polygon<Interval>& projected_hole, const std::vector<std::array<double, 3>>& hole_half_planes, MoveToFrontList<size_t>& recent_vertices, BoundaryMemo& memo, std::vector<Box2>& pruned_plug_boxes) {
+        const auto part_outside = [&](const Box2& part) {
+            if(!(plug_box_sample_depth(config_.polyhedron, hole_half_planes, part) < -half_screen_margin * vertex_radius_ * Angle::angle_radius<Interval>(part).to_float())) {
+                return false;
+            }
+            std::optional<PlugBoxEnclosures<Interval>> local_part;
+            return plug_box_outside(plug_box_enclosures(part, local_part), projected_hole, hole_half_planes, recent_vertices, memo);
+        };
+        return prune_plug_box_halves(plug_box, part_outside, pruned_plug_boxes);
+    }
+
+    // Halves the plug box along the angle that moves the vertex sticking out of the hole furthest the most, unless that
+    // angle is already refined deeper than the other, so that the boxes stay balanced as in the contraction
+    std::vector<Box2> split_plug_box(const Box2& plug_box, const std::vector<std::array<double, 3>>& hole_half_planes) const {
+        if(!config_.plug_margin_split) {
+            return plug_box.parts();
+        }
+        const std::vector<VertexMargin> margins = plug_box_vertex_margins(config_.polyhedron, vertex_indices_, hole_half_planes, plug_box);
+        const size_t margin_index = plug_box_split_index(config_.polyhedron, margins, plug_box);
+        const size_t index = plug_box.range(margin_index).depth() <= plug_box.range(1 - margin_index).depth() ? margin_index : 1 - margin_index;
+        const auto [min_part, max_part] = plug_box.parts(index);
+        return {min_part, max_part};
+    }
+
+    // The vertices that can be on the outline depend on theta and phi only, so a hull cached by a sibling that differs in
+    // alpha encloses the same vertices
+    Polygon<Interval> project_hole_box(const Box3& hole_box, const std::vector<size_t>& vertex_indices) {
+        const Range theta_range = Angle::theta_range(hole_box);
+        const Range phi_range = Angle::phi_range(hole_box);
+        const uint64_t key = uint64_t{theta_range.pack()} << 32 | phi_range.pack();
+        const std::shared_ptr<const std::vector<Vector2<Interval>>> hull_vectors = theta_phi_hulls_.get_or_compute(key, [&] {
+            return std::make_shared<const std::vector<Vector2<Interval>>>(
+                project_polyhedron_theta_phi(config_.polyhedron, vertex_indices, theta_range, phi_range, config_.resolution)
+            );
+        });
+        return rotate_projection(*hull_vectors, Angle::alpha_range(hole_box), config_.resolution);
+    }
+
+    std::tuple<bool, std::vector<Box2>, std::vector<Box2>> process_plug_boxes(const AngleBox<Interval, 3>& hole_box, const std::vector<size_t>& vertex_indices, const bool collect_unpruned_plug_boxes) {
+        const Polygon<Interval> projected_hole = project_hole_box(hole_box.box(), vertex_indices);
         bool prunable = true;
-        SerialQueue<Box2> plug_boxes;
-        plug_boxes.add(Box2(std::array{Range(Bitset(0, 0)), Range(Bitset(0, 0))}));
+        // when a single unpruned plug box decides the hole box, the plug boxes most likely to be unpruned go first,
+        // otherwise the order is first in first out
+        const std::vector<std::array<double, 3>> hole_half_planes = float_half_planes(projected_hole);
+        if(!collect_unpruned_plug_boxes && probe_unpruned_plug_box(hole_box, projected_hole, hole_half_planes)) {
+            return std::make_tuple(false, std::vector<Box2>(), std::vector<Box2>());
+        }
+        double sequence = 0;
+        const auto score_box = [&](const Box2& box) {
+            return ScoredBox(collect_unpruned_plug_boxes ? --sequence : plug_box_sample_depth(config_.polyhedron, hole_half_planes, box), box);
+        };
+        SerialPriorityQueue<ScoredBox> plug_box_queue;
+        SerialStack<ScoredBox> plug_box_stack;
+        plug_box_queue.add(score_box(Box2(std::array{Range(Bitset(0, 0)), Range(Bitset(0, 0))})));
         std::vector<Box2> pruned_plug_boxes;
         std::vector<Box2> unpruned_plug_boxes;
-        while(plug_boxes.size() > 0) {
-            const std::optional<Box2> optional_plug_box = plug_boxes.fetch();
+        MoveToFrontList<size_t> recent_vertices(recent_vertex_capacity);
+        BoundaryMemo memo(boundary_memo_capacity);
+        while(plug_box_queue.size() > 0 || plug_box_stack.size() > 0) {
+            // the subtree of a box taken from the stack is searched depth-first, so the stack stays linear in depth
+            const bool depth_first = plug_box_stack.size() > 0;
+            const std::optional<ScoredBox> optional_plug_box = depth_first ? plug_box_stack.fetch() : plug_box_queue.fetch();
             if(!optional_plug_box.has_value()) {
                 throw std::runtime_error("plug_boxes is empty");
             }
-            const Box2& plug_box = optional_plug_box.value();
-            if(hole_box_close_to_plug_box(config_.polyhedron, hole_box, plug_box, config_.epsilon - Angle::angle_radius<Interval>(hole_box) - Angle::angle_radius<Interval>(plug_box))) {
-                plug_boxes.ack();
+            if(depth_first) {
+                plug_box_stack.ack();
+            } else {
+                plug_box_queue.ack();
+            }
+            // deeper plug boxes get their enclosures only once they turn out to be in scope
+            const PlugBoxEnclosures<Interval>* shared_plug_box = shared_plug_box_enclosures(optional_plug_box->box);
+            std::optional<AngleBox<Interval, 2>> local_angle_box;
+            const AngleBox<Interval, 2>& angle_box = shared_plug_box != nullptr ? shared_plug_box->angle_box() : local_angle_box.emplace(optional_plug_box->box);
+            // how close the orientations of the boxes come decides both whether the plug box is out of scope and whether
+            // its sample inside the hole is too close to the hole box to count, it is evaluated once when first needed
+            std::optional<Interval> cos_angle;
+            const auto close = [&](const Interval& epsilon) {
+                if(!epsilon.pos()) {
+                    return false;
+                }
+                if(!cos_angle.has_value()) {
+                    cos_angle.emplace(hole_box_plug_box_cos_angle(config_.polyhedron, hole_box, angle_box));
+                }
+                return hole_box_close_to_plug_box(cos_angle.value(), epsilon);
+            };
+            if(close(config_.epsilon - hole_box.radius() - angle_box.radius())) {
                 continue;
             }
+            std::optional<PlugBoxEnclosures<Interval>> local_plug_box;
+            const PlugBoxEnclosures<Interval>& plug_box = shared_plug_box != nullptr ? *shared_plug_box : local_plug_box.emplace(config_.polyhedron, angle_box);
             if(plug_box_sample_inside_hole_box_sample(config_.polyhedron, hole_box, plug_box)) {
-                std::cout << "Rupert passage found for hole box: " << hole_box << " and plug box: " << plug_box << std::endl;
+                std::cout << "Rupert passage found for hole box: " << hole_box.box() << " and plug box: " << plug_box.box() << std::endl;
                 throw std::runtime_error("Rupert passage found");
             }
-            if(plug_box_sample_inside_hole_box(config_.polyhedron, projected_hole, plug_box) &&
-               !hole_box_close_to_plug_box(config_.polyhedron, hole_box, plug_box, config_.epsilon - Angle::angle_radius<Interval>(hole_box))) {
+            if(plug_box_sample_inside_hole_box(projected_hole, plug_box.sample_outline_indices(), plug_box) &&
+               !close(config_.epsilon - hole_box.radius())) {
                 if(collect_unpruned_plug_boxes) {
                     prunable = false;
-                    unpruned_plug_boxes.push_back(plug_box);
-                    plug_boxes.ack();
+                    unpruned_plug_boxes.push_back(plug_box.box());
                     continue;
                 }
                 return std::make_tuple(false, std::vector<Box2>(), std::vector<Box2>());
             }
-            if(plug_box_outside_hole_box(config_.polyhedron, plug_box, projected_hole)) {
-                pruned_plug_boxes.push_back(plug_box);
-                plug_boxes.ack();
+            if(plug_box_outside(plug_box, projected_hole, hole_half_planes, recent_vertices, memo)) {
+                pruned_plug_boxes.push_back(plug_box.box());
                 continue;
             }
-            if(Angle::angle_radius<Interval>(plug_box) < config_.plug_epsilon) {
+            if(plug_box.angle_box().radius() < config_.plug_epsilon) {
                 if(collect_unpruned_plug_boxes) {
                     prunable = false;
-                    unpruned_plug_boxes.push_back(plug_box);
-                    plug_boxes.ack();
+                    unpruned_plug_boxes.push_back(plug_box.box());
                     continue;
                 }
                 return std::make_tuple(false, std::vector<Box2>(), std::vector<Box2>());
             }
-            for(const Box2& rectangle_part: plug_box.parts()) {
-                plug_boxes.add(rectangle_part);
+            const bool split_depth_first = depth_first ||
+                                           config_.plug_search == PlugSearch::depth_first ||
+                                           (config_.plug_search == PlugSearch::hybrid && plug_box_queue.size() >= config_.plug_frontier_limit);
+            const std::optional<Box2> remaining_box = drop_outside_plug_halves(plug_box.box(), projected_hole, hole_half_planes, recent_vertices, memo, pruned_plug_boxes);
+            if(!remaining_box.has_value()) {
+                continue;
+            }
+            std::vector<ScoredBox> rectangle_parts;
+            for(const Box2& rectangle_part: split_plug_box(remaining_box.value(), hole_half_planes)) {
+                rectangle_parts.push_back(score_box(rectangle_part));
+            }
+            // ascending, so that the stack pops the best part first
+            std::stable_sort(rectangle_parts.begin(), rectangle_parts.end());
+            for(const ScoredBox& rectangle_part: rectangle_parts) {
+                if(split_depth_first) {
+                    plug_box_stack.add(rectangle_part);
+                } else {
+                    plug_box_queue.add(rectangle_part);
+                }
             }
-            plug_boxes.ack();
         }
         return std::make_tuple(prunable, pruned_plug_boxes, unpruned_plug_boxes);
     }
 
-    void process_hole_box(const Box3& hole_box) {
-        if(!(Angle::angle_radius<Interval>(hole_box) < Interval::pi() / Interval(2) * Interval(config_.resolution))) {
+    void process_hole_box(const HoleTask& hole_task) {
+        const Box3& hole_box = hole_task.box;
+        const AngleBox<Interval, 3> hole_angle_box(hole_box);
+        if(!(hole_angle_box.radius() < Interval::pi() / Interval(2) * Interval(config_.resolution))) {
             std::cout << "Skippable: " << hole_box << std::endl;
             for(const Box3& hole_box_part: hole_box.parts()) {
-                hole_boxes_.add(hole_box_part);
+                hole_boxes_.add(HoleTask(hole_box_part, hole_task.vertex_indices));
             }
             return;
         }
-        const bool collect_unpruned_plug_boxes = Angle::angle_radius<Interval>(hole_box) < config_.hole_epsilon;
-        const auto& [prunable, pruned_plug_boxes, unpruned_plug_boxes] = process_plug_boxes(hole_box, collect_unpruned_plug_boxes);
+        const std::shared_ptr<const std::vector<size_t>> vertex_indices = std::make_shared<const std::vector<size_t>>(
+            silhouette_vertex_indices(config_.polyhedron, hole_angle_box, *hole_task.vertex_indices)
+        );
+        const bool collect_unpruned_plug_boxes = hole_angle_box.radius() < config_.hole_epsilon;
+        const auto& [prunable, pruned_plug_boxes, unpruned_plug_boxes] = process_plug_boxes(hole_angle_box, *vertex_indices, collect_unpruned_plug_boxes);
         if(prunable) {
             std::cout << "Prunable: " << hole_box << std::endl;
             pruned_hole_boxes_.add(CombinedBoxes(hole_box, pruned_plug_boxes));
@@ -128,15 +351,15 @@ class GlobalSolver {
             return;
         }
         for(const Box3& hole_box_part: hole_box.parts()) {
-            hole_boxes_.add(hole_box_part);
+            hole_boxes_.add(HoleTask(hole_box_part, vertex_indices));
         }
     }
 
     void processor_hole_boxes() {
         while(!interrupted_ && hole_boxes_.size() > 0) {
-            const std::optional<Box3> optional_hole_box = hole_boxes_.fetch();
-            if(optional_hole_box.has_value()) {
-                process_hole_box(optional_hole_box.value());
+            const std::optional<HoleTask> optional_hole_task = hole_boxes_.fetch();
+            if(optional_hole_task.has_value()) {
+                process_hole_box(optional_hole_task.value());
                 hole_boxes_.ack();
             } else {
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -147,10 +370,19 @@ class GlobalSolver {
     }
 
 public:
-    explicit GlobalSolver(const Config<Interval>& config) : config_(config), exporter_latch_(config.threads) {}
+    explicit GlobalSolver(const Config<Interval>& config) :
+        config_(config),
+        vertex_indices_(all_vertex_indices(config.polyhedron)),
+        vertex_radius_(std::ranges::max(config.polyhedron.vertex_norms())),
+        exporter_latch_(config.threads),
+        shared_plug_depth_(shared_plug_depth(config.polyhedron.vertices().size())),
+        shared_plug_boxes_(shared_plug_box_count(shared_plug_depth_)) {}
 
     void run() {
-        hole_boxes_.add(Box3(std::array{Range(Bitset(0, 0)), Range(Bitset(1, 0)), Range(Bitset(1, 0))}));
+        hole_boxes_.add(HoleTask(
+            Box3(std::array{Range(Bitset(0, 0)), Range(Bitset(1, 0)), Range(Bitset(1, 0))}),
+            std::make_shared<const std::vector<size_t>>(vertex_indices_)
+        ));
         Exporter::create_empty_working_directory(config_.working_directory());
         Exporter::export_polyhedron(config_.working_directory() / polyhedron_file_name, config_.polyhedron);
         std::ranges::generate_n(std::back_inserter(threads_), config_.threads, [this] {
@@ -164,6 +396,9 @@ public:
         exporter_latch_.wait();
         Exporter::export_combined_boxes(config_.working_directory() / pruned_hole_boxes_file_name, pruned_hole_boxes_.flush());
         Exporter::export_combined_boxes(config_.working_directory() / unpruned_hole_boxes_file_name, unpruned_hole_boxes_.flush());
+        if(pruned_plug_box_count_ > 0) {
+            std::cout << "Vertices tried per pruned plug box: " << static_cast<double>(tried_vertex_count_) / static_cast<double>(pruned_plug_box_count_) << std::endl;
+        }
         mpfr_free_cache();
     }
 
@@ -2,16 +2,28 @@
 
 #include "geometry/geometry.hpp"
 #include "box/boxes.hpp"
+#include "cache/boundary_memo.hpp"
+#include "cache/move_to_front_list.hpp"
+#include "cache/published_table.hpp"
 #include <vector>
 #include <optional>
 #include <algorithm>
 #include <queue>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
 
 template<IntervalType Interval>
 Interval trivial_harmonic(const Interval& cos_amplitude, const Interval& sin_amplitude, const Interval& angle) {
     return cos_amplitude * angle.cos() + sin_amplitude * angle.sin();
 }
 
+template<IntervalType Interval>
+Interval trivial_harmonic(const Interval& cos_amplitude, const Interval& sin_amplitude, const AngleSample<Interval>& angle) {
+    return cos_amplitude * angle.cos() + sin_amplitude * angle.sin();
+}
+
 template<IntervalType Interval>
 Interval combined_harmonic(const Interval& cos_amplitude, const Interval& sin_amplitude, const Interval& angle) {
     if(cos_amplitude.nonz()) {
@@ -61,6 +73,54 @@ Vector2<Interval> trivial_box(const Vector3<Interval>& vector, const Interval& t
     );
 }
 
+template<IntervalType Interval>
+Vector2<Interval> trivial_box(const Vector3<Interval>& vector, const AngleSample<Interval>& theta, const AngleSample<Interval>& phi) {
+    return Vector2<Interval>(
+        trivial_harmonic(vector.x(), -vector.y(), theta),
+        trivial_harmonic(trivial_harmonic(vector.y(), vector.x(), theta), -vector.z(), phi)
+    );
+}
+
+template<IntervalType Interval>
+Interval intersection(const Interval& interval, const Interval& other_interval) {
+    const Interval lower = interval.min() < other_interval.min() ? other_interval.min() : interval.min();
+    const Interval upper = other_interval.max() < interval.max() ? other_interval.max() : interval.max();
+    return lower.hull(upper);
+}
+
+// Centred form of trivial_box over a whole box: the projection of the centre plus the derivatives, enclosed over the box,
+// times the offsets from the centre. Its overestimation shrinks quadratically with the box instead of linearly.
+// dX/dtheta = -x * sin(theta) - y * cos(theta)
+// dY/dtheta = (x * cos(theta) - y * sin(theta)) * cos(phi)
+// dY/dphi = -(y * cos(theta) + x * sin(theta)) * sin(phi) - z * cos(phi)
+template<IntervalType Interval>
+Vector2<Interval> centred_box(const Vector3<Interval>& vector, const AngleRange<Interval>& theta, const AngleRange<Interval>& phi) {
+    const Vector2<Interval> centre = trivial_box(vector, theta.mid(), phi.mid());
+    const Vector2<Interval> natural = trivial_box(vector, theta.value(), phi.value());
+    const Interval theta_offset = theta.value().angle() - theta.mid().angle();
+    const Interval phi_offset = phi.value().angle() - phi.mid().angle();
+    const Interval x_theta = trivial_harmonic(-vector.y(), -vector.x(), theta.value());
+    const Interval y_theta = trivial_harmonic(vector.x(), -vector.y(), theta.value()) * phi.value().cos();
+    const Interval y_phi = trivial_harmonic(-vector.z(), -trivial_harmonic(vector.y(), vector.x(), theta.value()), phi.value());
+    return Vector2<Interval>(
+        intersection(centre.x() + x_theta * theta_offset, natural.x()),
+        intersection(centre.y() + y_theta * theta_offset + y_phi * phi_offset, natural.y())
+    );
+}
+
+template<IntervalType Interval>
+Matrix<Interval> mid_orientation(const AngleBox<Interval, 2>& box) {
+    return Matrix<Interval>::rotation_x(box.phi().mid().cos(), box.phi().mid().sin()) *
+           Matrix<Interval>::rotation_z(box.theta().mid().cos(), box.theta().mid().sin());
+}
+
+template<IntervalType Interval>
+Matrix<Interval> mid_orientation(const AngleBox<Interval, 3>& box) {
+    return Matrix<Interval>::rotation_z(box.alpha().mid().cos(), box.alpha().mid().sin()) *
+           Matrix<Interval>::rotation_x(box.phi().mid().cos(), box.phi().mid().sin()) *
+           Matrix<Interval>::rotation_z(box.theta().mid().cos(), box.theta().mid().sin());
+}
+
 template<IntervalType Interval>
 Vector2<Interval> combined_projected_box(const Vector3<Interval>& vector, const Interval& theta, const Interval& phi) {
     return Vector2<Interval>(
@@ -110,9 +170,9 @@ std::vector<Vector2<Interval>> projected_box_hull(const Vector3<Interval>& vecto
     return hull;
 }
 
+// projected_vector encloses the projection along the edge, which runs vertically
 template<IntervalType Interval>
-bool projected_oriented_vector_avoids_polygon_fixed_theta(const Polygon<Interval>& polygon, const Vector3<Interval>& vector, const Interval& theta, const Interval& phi) {
-    const Vector2<Interval> projected_vector = combined_projected_box(vector, theta, phi);
+bool projected_oriented_vector_avoids_polygon_fixed_theta(const Polygon<Interval>& polygon, const Vector2<Interval>& projected_vector) {
     const Edge projected_edge(
         Vector2<Interval>(projected_vector.x(), projected_vector.y().min()),
         Vector2<Interval>(projected_vector.x(), projected_vector.y().max())
@@ -122,8 +182,9 @@ bool projected_oriented_vector_avoids_polygon_fixed_theta(const Polygon<Interval
     });
 }
 
+// min_projected_vector and max_projected_vector are the projections at the ends of the theta range
 template<IntervalType Interval>
-bool projected_oriented_vector_avoids_edge_fixed_phi(const Vector3<Interval>& vector, const Interval& theta, const Interval& phi, const Edge<Interval>& edge) {
+bool projected_oriented_vector_avoids_edge_fixed_phi(const Vector3<Interval>& vector, const Vector2<Interval>& min_projected_vector, const Vector2<Interval>& max_projected_vector, const AngleSample<Interval>& phi, const Edge<Interval>& edge) {
     const Interval translation_factor = vector.z() * phi.sin();
     const Interval scaling_factor = phi.cos();
     const Vector2<Interval> transformed_edge_from(
@@ -150,8 +211,6 @@ bool projected_oriented_vector_avoids_edge_fixed_phi(const Vector3<Interval>& ve
         (-linear_term - sqrt_discriminant) / (Interval(2) * quadratic_term)
     };
 
-    const Vector2<Interval> min_projected_vector = trivial_box(vector, theta.min(), phi);
-    const Vector2<Interval> max_projected_vector = trivial_box(vector, theta.max(), phi);
     const Vector2<Interval> transformed_min_projected_vector = Vector2<Interval>(
         min_projected_vector.x(),
         (min_projected_vector.y() + translation_factor) / scaling_factor
@@ -171,28 +230,70 @@ bool projected_oriented_vector_avoids_edge_fixed_phi(const Vector3<Interval>& ve
 }
 
 template<IntervalType Interval>
-bool projected_oriented_vector_avoids_polygon_fixed_phi(const Polygon<Interval>& polygon, const Vector3<Interval>& vector, const Interval& theta, const Interval& phi) {
+bool projected_oriented_vector_avoids_polygon_fixed_phi(const Polygon<Interval>& polygon, const Vector3<Interval>& vector, const AngleRange<Interval>& theta, const AngleSample<Interval>& phi, const Vector2<Interval>& min_projected_vector, const Vector2<Interval>& max_projected_vector) {
     if(!phi.cos().nonz()) {
-        return polygon.outside(combined_projected_box(vector, theta, phi));
+        return polygon.outside(combined_projected_box(vector, theta.value().angle(), phi.angle()));
     }
     return std::ranges::all_of(polygon.edges(), [&](const Edge<Interval>& edge) {
-        return projected_oriented_vector_avoids_edge_fixed_phi(vector, theta, phi, edge);
+        return projected_oriented_vector_avoids_edge_fixed_phi(vector, min_projected_vector, max_projected_vector, phi, edge);
     });
 }
 
+// Decides with the enclosure of the projection over the whole box where possible, otherwise leaves it to the boundary of
+// the box
 template<IntervalType Interval>
-bool projected_oriented_vector_avoids_polygon(const Polygon<Interval>& polygon, const Vector3<Interval>& vector, const Interval& theta, const Interval& phi) {
-    if(!(theta.len() < Interval::pi() / Interval(2))) {
-        return polygon.outside(combined_projected_box(vector, theta, phi));
+std::optional<bool> projected_oriented_vector_avoids_polygon_without_boundary(const Polygon<Interval>& polygon, const Vector3<Interval>& vector, const Vector2<Interval>& projected_box, const AngleRange<Interval>& theta, const AngleRange<Interval>& phi) {
+    // The projection never lengthens the vector, so inside the inscribed circle it can not leave the polygon
+    if(vector.len() < polygon.inradius()) {
+        return false;
+    }
+    if(polygon.beyond_support(projected_box)) {
+        return true;
+    }
+    if(!(theta.value().angle().len() < Interval::pi() / Interval(2))) {
+        return polygon.outside(combined_projected_box(vector, theta.value().angle(), phi.value().angle()));
+    }
+    return std::nullopt;
+}
+
+// Enclosures of the projection of a vertex over a plug box that do not depend on the hole: over the whole box, at the
+// corners, and along the edges of fixed theta
+template<IntervalType Interval>
+struct ProjectedVertexEnclosures {
+    Vector2<Interval> box;
+    Vector2<Interval> theta_min_phi_min;
+    Vector2<Interval> theta_max_phi_max;
+    Vector2<Interval> theta_min_phi_max;
+    Vector2<Interval> theta_max_phi_min;
+    Vector2<Interval> theta_min_edge;
+    Vector2<Interval> theta_max_edge;
+
+    ProjectedVertexEnclosures(const Vector3<Interval>& vector, const AngleRange<Interval>& theta, const AngleRange<Interval>& phi) :
+        box(centred_box(vector, theta, phi)),
+        theta_min_phi_min(trivial_box(vector, theta.min(), phi.min())),
+        theta_max_phi_max(trivial_box(vector, theta.max(), phi.max())),
+        theta_min_phi_max(trivial_box(vector, theta.min(), phi.max())),
+        theta_max_phi_min(trivial_box(vector, theta.max(), phi.min())),
+        theta_min_edge(combined_projected_box(vector, theta.min().angle(), phi.value().angle())),
+        theta_max_edge(combined_projected_box(vector, theta.max().angle(), phi.value().angle())) {}
+};
+
+// The boundary of a plug box: the four corners, the two edges of fixed theta and the two edges of fixed phi
+constexpr size_t plug_box_boundary_size = 8;
+
+// Tests the element of the boundary of the plug box with the given index, in the order of plug_box_boundary_size
+template<IntervalType Interval>
+bool projected_oriented_vector_avoids_polygon_boundary(const Polygon<Interval>& polygon, const Vector3<Interval>& vector, const AngleRange<Interval>& theta, const AngleRange<Interval>& phi, const ProjectedVertexEnclosures<Interval>& enclosures, const size_t index) {
+    switch(index) {
+        case 0: return polygon.outside(enclosures.theta_min_phi_min);
+        case 1: return polygon.outside(enclosures.theta_max_phi_max);
+        case 2: return polygon.outside(enclosures.theta_min_phi_max);
+        case 3: return polygon.outside(enclosures.theta_max_phi_min);
+        case 4: return projected_oriented_vector_avoids_polygon_fixed_theta(polygon, enclosures.theta_min_edge);
+        case 5: return projected_oriented_vector_avoids_polygon_fixed_theta(polygon, enclosures.theta_max_edge);
+        case 6: return projected_oriented_vector_avoids_polygon_fixed_phi(polygon, vector, theta, phi.min(), enclosures.theta_min_phi_min, enclosures.theta_max_phi_min);
+        default: return projected_oriented_vector_avoids_polygon_fixed_phi(polygon, vector, theta, phi.max(), enclosures.theta_min_phi_max, enclosures.theta_max_phi_max);
     }
-    return polygon.outside(trivial_box(vector, theta.min(), phi.min())) &&
-           polygon.outside(trivial_box(vector, theta.max(), phi.max())) &&
-           polygon.outside(trivial_box(vector, theta.min(), phi.max())) &&
-           polygon.outside(trivial_box(vector, theta.max(), phi.min())) &&
-           projected_oriented_vector_avoids_polygon_fixed_theta(polygon, vector, theta.min(), phi) &&
-           projected_oriented_vector_avoids_polygon_fixed_theta(polygon, vector, theta.max(), phi) &&
-           projected_oriented_vector_avoids_polygon_fixed_phi(polygon, vector, theta, phi.min()) &&
-           projected_oriented_vector_avoids_polygon_fixed_phi(polygon, vector, theta, phi.max());
 }
 
 template<IntervalType Interval>
@@ -264,7 +365,7 @@ std::vector<Vector2<Interval>> deduplicate_vectors(const std::vector<Vector2<Int
 }
 
 template<IntervalType Interval>
-Polygon<Interval> convex_hull(const std::vector<Vector2<Interval>>& vectors) {
+Polygon<Interval> convex_hull(const std::vector<Vector2<Interval>>& vectors, const bool centrally_symmetric = false) {
     std::vector<Edge<Interval>> edges;
 
     std::queue<size_t> queue;
@@ -354,34 +455,262 @@ Polygon<Interval> convex_hull(const std::vector<Vector2<Interval>>& vectors) {
             edges.emplace_back(vectors[from_edge_index], vectors[to_edge_index]);
         }
     }
-    return Polygon(edges);
+    return Polygon(edges, centrally_symmetric);
 }
 
 template<IntervalType Interval>
-Polygon<Interval> project_polyhedron(const Polyhedron<Interval>& polyhedron, const Box3& box, const int resolution) {
+std::vector<size_t> all_vertex_indices(const Polyhedron<Interval>& polyhedron) {
+    std::vector<size_t> vertex_indices(polyhedron.vertices().size());
+    std::iota(vertex_indices.begin(), vertex_indices.end(), 0);
+    return vertex_indices;
+}
+
+// A vertex whose faces all certainly face the same way for every view direction of the box projects strictly inside the
+// outline for every orientation of the box, and so for every orientation of its parts. Returns the other vertices.
+template<IntervalType Interval, size_t Size>
+std::vector<size_t> silhouette_vertex_indices(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, Size>& box, const std::vector<size_t>& vertex_indices) {
+    const Matrix<Interval> matrix = Matrix<Interval>::rotation_x(box.phi().value().cos(), box.phi().value().sin()) *
+                                    Matrix<Interval>::rotation_z(box.theta().value().cos(), box.theta().value().sin());
+    const Vector3<Interval> direction = matrix.transpose() * Vector3<Interval>(Interval(0), Interval(0), Interval(1));
+    // when every face certainly faces the same way over the whole box, the silhouette is one of the computed outlines
+    const NormalMask normal_mask = polyhedron.get_normal_mask(direction);
+    if(!normal_mask.none()) {
+        if(const std::optional<size_t> outline_index = polyhedron.find_outline(normal_mask)) {
+            std::vector<bool> outline_vertices(polyhedron.vertices().size(), false);
+            for(const size_t vertex_index: polyhedron.outlines()[outline_index.value()].vertex_indices) {
+                outline_vertices[vertex_index] = true;
+            }
+            std::vector<size_t> outline_indices;
+            std::ranges::copy_if(vertex_indices, std::back_inserter(outline_indices), [&](const size_t vertex_index) {
+                return outline_vertices[vertex_index];
+            });
+            return outline_indices;
+        }
+    }
+    constexpr int unseen = 0;
+    constexpr int mixed = 2;
+    std::vector<int> vertex_signs(polyhedron.vertices().size(), unseen);
+    for(size_t face_index = 0; face_index < polyhedron.faces().size(); ++face_index) {
+        const Interval dot = direction.dot(polyhedron.face_normals()[face_index]);
+        const int sign = dot.pos() ? 1 : dot.neg() ? -1 : mixed;
+        for(const size_t vertex_index: polyhedron.faces()[face_index]) {
+            int& vertex_sign = vertex_signs[vertex_index];
+            vertex_sign = vertex_sign == unseen || vertex_sign == sign ? sign : mixed;
+        }
+    }
+    std::vector<size_t> silhouette_indices;
+    for(const size_t vertex_index: vertex_indices) {
+        if(vertex_signs[vertex_index] == mixed) {
+            silhouette_indices.push_back(vertex_index);
+        }
+    }
+    return silhouette_indices;
+}
+
+// Vertices that may be on the outline of the plug somewhere in the box, classified in floats: the view direction moves by
+// at most twice the radius of the box, so a unit face normal further than that from perpendicular keeps its side. Only a
+// selection of candidates for predicates that are sound for any subset of the vertices.
+template<IntervalType Interval>
+std::vector<size_t> plug_outline_candidate_indices(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 2>& plug_box) {
+    const Vector3<Interval> direction = mid_orientation(plug_box).transpose() * Vector3<Interval>(Interval(0), Interval(0), Interval(1));
+    const double direction_x = direction.x().to_float();
+    const double direction_y = direction.y().to_float();
+    const double direction_z = direction.z().to_float();
+    const double margin = 2 * plug_box.radius().to_float();
+    constexpr int unseen = 0;
+    constexpr int mixed = 2;
+    std::vector<int> vertex_signs(polyhedron.vertices().size(), unseen);
+    for(size_t face_index = 0; face_index < polyhedron.faces().size(); ++face_index) {
+        const Vector3<Interval>& normal = polyhedron.face_normals()[face_index];
+        const double dot = direction_x * normal.x().to_float() + direction_y * normal.y().to_float() + direction_z * normal.z().to_float();
+        const int sign = dot > margin ? 1 : dot < -margin ? -1 : mixed;
+        for(const size_t vertex_index: polyhedron.faces()[face_index]) {
+            int& vertex_sign = vertex_signs[vertex_index];
+            vertex_sign = vertex_sign == unseen || vertex_sign == sign ? sign : mixed;
+        }
+    }
+    std::vector<size_t> candidate_indices;
+    for(size_t vertex_index = 0; vertex_index < vertex_signs.size(); ++vertex_index) {
+        if(vertex_signs[vertex_index] == mixed) {
+            candidate_indices.push_back(vertex_index);
+        }
+    }
+    return candidate_indices;
+}
+
+// Vertices on the outline of the plug at the centre of the box, or all vertices if that outline is not certain
+template<IntervalType Interval>
+std::vector<size_t> plug_sample_outline_indices(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 2>& plug_box) {
+    const Vector3<Interval> direction = mid_orientation(plug_box).transpose() * Vector3<Interval>(Interval(0), Interval(0), Interval(1));
+    const std::optional<size_t> outline_index = polyhedron.find_outline(polyhedron.get_normal_mask(direction));
+    if(!outline_index.has_value()) {
+        return all_vertex_indices(polyhedron);
+    }
+    return polyhedron.outlines()[outline_index.value()].vertex_indices;
+}
+
+// Everything the predicates derive from a plug box alone: its angles, the vertices that may be on its outline, the
+// projections of the vertices at its centre, and the enclosures of each vertex, computed when first asked for. Nothing
+// depends on the hole, so the searches of all hole boxes can share it between threads.
+template<IntervalType Interval>
+class PlugBoxEnclosures {
+    const Polyhedron<Interval>& polyhedron_;
+    AngleBox<Interval, 2> angle_box_;
+    std::vector<size_t> outline_candidate_indices_;
+    std::vector<size_t> sample_outline_indices_;
+    std::vector<Vector2<Interval>> sample_projections_{};
+    PublishedTable<ProjectedVertexEnclosures<Interval>> vertex_enclosures_;
+
+public:
+    PlugBoxEnclosures(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 2>& plug_box) :
+        polyhedron_(polyhedron),
+        angle_box_(plug_box),
+        outline_candidate_indices_(plug_outline_candidate_indices(polyhedron, angle_box_)),
+        sample_outline_indices_(plug_sample_outline_indices(polyhedron, angle_box_)),
+        vertex_enclosures_(polyhedron.vertices().size()) {
+        for(const Vector3<Interval>& vertex: polyhedron.vertices()) {
+            sample_projections_.push_back(trivial_box(vertex, angle_box_.theta().mid(), angle_box_.phi().mid()));
+        }
+    }
+
+    ~PlugBoxEnclosures() = default;
+
+    PlugBoxEnclosures(const PlugBoxEnclosures& enclosures) = delete;
+
+    PlugBoxEnclosures(PlugBoxEnclosures&& enclosures) = delete;
+
+    PlugBoxEnclosures& operator=(const PlugBoxEnclosures&) = delete;
+
+    PlugBoxEnclosures& operator=(PlugBoxEnclosures&&) = delete;
+
+    const AngleBox<Interval, 2>& angle_box() const {
+        return angle_box_;
+    }
+
+    const Box2& box() const {
+        return angle_box_.box();
+    }
+
+    // vertices that may be on the outline of the plug anywhere in the box
+    const std::vector<size_t>& outline_candidate_indices() const {
+        return outline_candidate_indices_;
+    }
+
+    // vertices on the outline of the plug at the centre of the box, or all vertices if that outline is not certain
+    const std::vector<size_t>& sample_outline_indices() const {
+        return sample_outline_indices_;
+    }
+
+    const Vector2<Interval>& sample_projection(const size_t vertex_index) const {
+        return sample_projections_[vertex_index];
+    }
+
+    const ProjectedVertexEnclosures<Interval>& vertex_enclosures(const size_t vertex_index) const {
+        return vertex_enclosures_.get_or_publish(vertex_index, [&] {
+            return std::make_unique<const ProjectedVertexEnclosures<Interval>>(polyhedron_.vertices()[vertex_index], angle_box_.theta(), angle_box_.phi());
+        });
+    }
+};
+
+// projected_oriented_vector_avoids_polygon for a vertex of the polyhedron, with the enclosures kept with the plug box, and
+// with the corners and edges of the plug box looked up in the memo of the search, where the neighbours and the parent of
+// the plug box left them. A boundary element known to fail decides first.
+template<IntervalType Interval>
+bool projected_oriented_vector_avoids_polygon(const Polygon<Interval>& polygon, const size_t vertex_index, const Vector3<Interval>& vector, const PlugBoxEnclosures<Interval>& plug_box, BoundaryMemo& memo) {
+    const AngleRange<Interval>& theta = plug_box.angle_box().theta();
+    const AngleRange<Interval>& phi = plug_box.angle_box().phi();
+    const ProjectedVertexEnclosures<Interval>& enclosures = plug_box.vertex_enclosures(vertex_index);
+    if(const std::optional<bool> result = projected_oriented_vector_avoids_polygon_without_boundary(polygon, vector, enclosures.box, theta, phi)) {
+        return result.value();
+    }
+    const Range& theta_range = Angle::theta_range(plug_box.box());
+    const Range& phi_range = Angle::phi_range(plug_box.box());
+    const std::array<BoundaryKey, plug_box_boundary_size> keys = {
+        BoundaryKey::corner(vertex_index, theta_range.min_key(), phi_range.min_key()),
+        BoundaryKey::corner(vertex_index, theta_range.max_key(), phi_range.max_key()),
+        BoundaryKey::corner(vertex_index, theta_range.min_key(), phi_range.max_key()),
+        BoundaryKey::corner(vertex_index, theta_range.max_key(), phi_range.min_key()),
+        BoundaryKey::fixed_theta(vertex_index, theta_range.min_key(), phi_range.pack()),
+        BoundaryKey::fixed_theta(vertex_index, theta_range.max_key(), phi_range.pack()),
+        BoundaryKey::fixed_phi(vertex_index, theta_range.pack(), phi_range.min_key()),
+        BoundaryKey::fixed_phi(vertex_index, theta_range.pack(), phi_range.max_key())
+    };
+    if(std::ranges::any_of(keys, [&](const BoundaryKey& key) {
+        return memo.get(key) == false;
+    })) {
+        return false;
+    }
+    for(size_t index = 0; index < keys.size(); ++index) {
+        if(!memo.get_or_compute(keys[index], [&] { return projected_oriented_vector_avoids_polygon_boundary(polygon, vector, theta, phi, enclosures, index); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Corners of the hull of the projection over theta and phi, which is shared by all hole boxes differing only in alpha
+template<IntervalType Interval>
+std::vector<Vector2<Interval>> project_polyhedron_theta_phi(const Polyhedron<Interval>& polyhedron, const std::vector<size_t>& vertex_indices, const Range& theta_range, const Range& phi_range, const int resolution) {
+    // the projection is linear, so the projection of an antipodal vertex is the reflection of the projection
+    std::vector<bool> selected(polyhedron.vertices().size(), false);
+    for(const size_t vertex_index: vertex_indices) {
+        selected[vertex_index] = true;
+    }
     std::vector<Vector2<Interval>> projected_vectors;
-    for(const Vector3<Interval>& vertex: polyhedron.vertices()) {
-        for(const Vector2<Interval>& vectors: projected_box_hull(vertex, Angle::theta_range(box), Angle::phi_range(box), resolution)) {
-            for(const Vector2<Interval>& vector: rotation_hull(vectors, Angle::alpha_range(box), resolution)) {
-                projected_vectors.push_back(vector);
+    for(const size_t vertex_index: vertex_indices) {
+        const size_t antipode = polyhedron.antipodes()[vertex_index];
+        const bool mirrored = selected[antipode] && antipode != vertex_index;
+        if(mirrored && antipode < vertex_index) {
+            continue;
+        }
+        const Vector3<Interval>& vertex = polyhedron.vertices()[vertex_index];
+        for(const Vector2<Interval>& vector: projected_box_hull(vertex, theta_range, phi_range, resolution)) {
+            projected_vectors.push_back(vector);
+            if(mirrored) {
+                projected_vectors.push_back(-vector);
             }
         }
     }
-    return convex_hull(deduplicate_vectors(projected_vectors));
+    const Polygon<Interval> projected_hull = convex_hull(deduplicate_vectors(projected_vectors));
+    std::vector<Vector2<Interval>> hull_vectors;
+    for(const Edge<Interval>& edge: projected_hull.edges()) {
+        hull_vectors.push_back(edge.from());
+    }
+    return hull_vectors;
+}
+
+// Alpha rotates the projection rigidly, so only the corners of the hull over theta and phi are swept over alpha
+template<IntervalType Interval>
+Polygon<Interval> rotate_projection(const std::vector<Vector2<Interval>>& hull_vectors, const Range& alpha_range, const int resolution) {
+    std::vector<Vector2<Interval>> rotated_vectors;
+    for(const Vector2<Interval>& hull_vector: hull_vectors) {
+        for(const Vector2<Interval>& vector: rotation_hull(hull_vector, alpha_range, resolution)) {
+            rotated_vectors.push_back(vector);
+        }
+    }
+    // the polygon encloses the projection of a centrally symmetric polyhedron, however its corners were chosen
+    return convex_hull(deduplicate_vectors(rotated_vectors), true);
+}
+
+template<IntervalType Interval>
+Polygon<Interval> project_polyhedron(const Polyhedron<Interval>& polyhedron, const std::vector<size_t>& vertex_indices, const Box3& box, const int resolution) {
+    return rotate_projection(
+        project_polyhedron_theta_phi(polyhedron, vertex_indices, Angle::theta_range(box), Angle::phi_range(box), resolution),
+        Angle::alpha_range(box),
+        resolution
+    );
 }
 
+// Projection of the hole at the centre of the hole box, if its outline is certain
 template<IntervalType Interval>
-bool plug_box_sample_inside_hole_box_sample(const Polyhedron<Interval>& polyhedron, const Box3& hole_box, const Box2& plug_box) {
-    const Matrix<Interval> hole_matrix = Matrix<Interval>::orientation(Angle::theta_mid<Interval>(hole_box), Angle::phi_mid<Interval>(hole_box), Angle::alpha_mid<Interval>(hole_box));
+std::optional<Polygon<Interval>> project_hole_box_sample(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 3>& hole_box) {
+    const Matrix<Interval> hole_matrix = mid_orientation(hole_box);
     const Vector3<Interval> direction = hole_matrix.transpose() * Vector3<Interval>(Interval(0), Interval(0), Interval(1));
-    const Bitset normal_mask = polyhedron.get_normal_mask(direction);
-    const auto outline_iterator = std::ranges::find_if(polyhedron.outlines(), [&](const Outline& candidate_outline) {
-        return candidate_outline.normal_mask == normal_mask;
-    });
-    if(outline_iterator == polyhedron.outlines().end()) {
-        return false;
+    const std::optional<size_t> outline_index = polyhedron.find_outline(polyhedron.get_normal_mask(direction));
+    if(!outline_index.has_value()) {
+        return std::nullopt;
     }
-    const Outline& outline = *outline_iterator;
+    const Outline& outline = polyhedron.outlines()[outline_index.value()];
     std::vector<Vector2<Interval>> projected_vertices;
     for(const size_t vertex_index: outline.vertex_indices) {
         const Vector3<Interval> vertex = polyhedron.vertices()[vertex_index];
@@ -396,36 +725,224 @@ bool plug_box_sample_inside_hole_box_sample(const Polyhedron<Interval>& polyhedr
         const size_t next_index = (index + 1) % projected_vertices.size();
         projected_edges.emplace_back(projected_vertices[index], projected_vertices[next_index]);
     }
-    const Polygon<Interval> projected_hole = Polygon<Interval>(projected_edges);
-    return plug_box_sample_inside_hole_box(polyhedron, projected_hole, plug_box);
+    return std::make_optional<Polygon<Interval>>(projected_edges);
 }
 
+// The hole is convex, so the plug sample is inside it if the vertices that can be on the outline of the plug are
 template<IntervalType Interval>
-bool plug_box_sample_inside_hole_box(const Polyhedron<Interval>& polyhedron, const Polygon<Interval>& projected_hole, const Box2& plug_box) {
-    return std::ranges::all_of(polyhedron.vertices(), [&](const Vector3<Interval>& vertex) {
-        return projected_hole.inside(trivial_box(vertex, Angle::theta_mid<Interval>(plug_box), Angle::phi_mid<Interval>(plug_box)));
+bool plug_box_sample_inside_hole_box(const Polygon<Interval>& projected_hole, const std::vector<size_t>& vertex_indices, const PlugBoxEnclosures<Interval>& plug_box) {
+    return std::ranges::all_of(vertex_indices, [&](const size_t vertex_index) {
+        return projected_hole.inside(plug_box.sample_projection(vertex_index));
     });
 }
 
 template<IntervalType Interval>
-bool hole_box_close_to_plug_box(const Polyhedron<Interval>& polyhedron, const Box3& hole_box, const Box2& plug_box, const Interval& epsilon) {
-    if(!epsilon.pos()) {
-        return false;
+bool plug_box_sample_inside_hole_box_sample(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 3>& hole_box, const PlugBoxEnclosures<Interval>& plug_box) {
+    const std::optional<Polygon<Interval>> projected_hole = project_hole_box_sample(polyhedron, hole_box);
+    return projected_hole.has_value() && plug_box_sample_inside_hole_box(projected_hole.value(), all_vertex_indices(polyhedron), plug_box);
+}
+
+// (nx, ny, c) per edge, scaled so that nx * x + ny * y + c is the signed distance to the edge, positive inside
+template<IntervalType Interval>
+std::vector<std::array<double, 3>> float_half_planes(const Polygon<Interval>& polygon) {
+    std::vector<std::array<double, 3>> half_planes;
+    for(const Edge<Interval>& edge: polygon.edges()) {
+        const double from_x = edge.from().x().to_float();
+        const double from_y = edge.from().y().to_float();
+        const double dx = edge.to().x().to_float() - from_x;
+        const double dy = edge.to().y().to_float() - from_y;
+        const double len = std::hypot(dx, dy);
+        half_planes.push_back({-dy / len, dx / len, (dy * from_x - dx * from_y) / len});
+    }
+    return half_planes;
+}
+
+// Floating point estimate of how deep the plug sample lies inside the projected hole, negative if it sticks out
+template<IntervalType Interval>
+double plug_box_sample_depth(const Polyhedron<Interval>& polyhedron, const std::vector<std::array<double, 3>>& hole_half_planes, const Box2& plug_box) {
+    const double theta = Angle::theta_mid<Interval>(plug_box).to_float();
+    const double phi = Angle::phi_mid<Interval>(plug_box).to_float();
+    const double cos_theta = std::cos(theta);
+    const double sin_theta = std::sin(theta);
+    const double cos_phi = std::cos(phi);
+    const double sin_phi = std::sin(phi);
+    double depth = std::numeric_limits<double>::infinity();
+    for(const Vector3<Interval>& vertex: polyhedron.vertices()) {
+        const double x = vertex.x().to_float();
+        const double y = vertex.y().to_float();
+        const double z = vertex.z().to_float();
+        const double projected_x = x * cos_theta - y * sin_theta;
+        const double projected_y = (y * cos_theta + x * sin_theta) * cos_phi - z * sin_phi;
+        for(const auto& [normal_x, normal_y, offset]: hole_half_planes) {
+            depth = std::min(depth, normal_x * projected_x + normal_y * projected_y + offset);
+        }
     }
-    const Interval cos_remaining_angle = epsilon.cos();
-    const Matrix<Interval> hole_matrix = Matrix<Interval>::orientation(Angle::theta_mid<Interval>(hole_box), Angle::phi_mid<Interval>(hole_box), Angle::alpha_mid<Interval>(hole_box));
-    const Matrix<Interval> plug_matrix = Matrix<Interval>::orientation(Angle::theta_mid<Interval>(plug_box), Angle::phi_mid<Interval>(plug_box));
-    return std::ranges::any_of(polyhedron.rotations(), [&](const Matrix<Interval>& rotation) {
-               return cos_remaining_angle < Matrix<Interval>::relative_rotation(plug_matrix, hole_matrix * rotation).cos_angle();
-           }) ||
-           std::ranges::any_of(polyhedron.reflections(), [&](const Matrix<Interval>& reflection) {
-               return cos_remaining_angle < Matrix<Interval>::relative_rotation(plug_matrix, Matrix<Interval>::reflection_z() * hole_matrix * reflection).cos_angle();
-           });
+    return depth;
 }
 
+// Cosine of the angle between the orientations at the centres of the boxes, up to the symmetries of the polyhedron, taken
+// over the symmetry that brings them closest, so that one evaluation serves every epsilon
 template<IntervalType Interval>
-bool plug_box_outside_hole_box(const Polyhedron<Interval>& polyhedron, const Box2& plug_box, const Polygon<Interval>& projected_hole) {
-    return std::ranges::any_of(polyhedron.vertices(), [&](const Vector3<Interval>& vertex) {
-        return projected_oriented_vector_avoids_polygon(projected_hole, vertex, Angle::theta<Interval>(plug_box), Angle::phi<Interval>(plug_box));
+Interval hole_box_plug_box_cos_angle(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 3>& hole_box, const AngleBox<Interval, 2>& plug_box) {
+    const Matrix<Interval> hole_matrix = mid_orientation(hole_box);
+    const Matrix<Interval> plug_matrix = mid_orientation(plug_box);
+    std::vector<Interval> cos_angles;
+    for(const Matrix<Interval>& rotation: polyhedron.rotations()) {
+        cos_angles.push_back(Matrix<Interval>::relative_rotation(plug_matrix, hole_matrix * rotation).cos_angle());
+    }
+    for(const Matrix<Interval>& reflection: polyhedron.reflections()) {
+        cos_angles.push_back(Matrix<Interval>::relative_rotation(plug_matrix, Matrix<Interval>::reflection_z() * hole_matrix * reflection).cos_angle());
+    }
+    return *std::ranges::max_element(cos_angles, [](const Interval& cos_angle, const Interval& other_cos_angle) {
+        return cos_angle.min() < other_cos_angle.min();
     });
 }
+
+template<IntervalType Interval>
+bool hole_box_close_to_plug_box(const Interval& cos_angle, const Interval& epsilon) {
+    return epsilon.pos() && epsilon.cos() < cos_angle;
+}
+
+template<IntervalType Interval>
+bool hole_box_close_to_plug_box(const Polyhedron<Interval>& polyhedron, const AngleBox<Interval, 3>& hole_box, const AngleBox<Interval, 2>& plug_box, const Interval& epsilon) {
+    return epsilon.pos() && hole_box_close_to_plug_box(hole_box_plug_box_cos_angle(polyhedron, hole_box, plug_box), epsilon);
+}
+
+// How far the projection of a vertex at the centre of a plug box sticks out of the hole in floats, negative inside, and
+// the half plane of the hole it sticks out of furthest. Margins are heuristic: the half planes are rounded from the
+// hole and the projection is taken in floats, so they may be off by rounding either way and are never part of a proof.
+// They only order the vertices tried and choose the split, every decision is then made with intervals.
+struct VertexMargin {
+    size_t index;
+    double distance;
+    std::array<double, 3> half_plane;
+};
+
+template<IntervalType Interval>
+std::vector<VertexMargin> plug_box_vertex_margins(const Polyhedron<Interval>& polyhedron, const std::vector<size_t>& vertex_indices, const std::vector<std::array<double, 3>>& hole_half_planes, const Box2& plug_box) {
+    const double theta = Angle::theta_mid<Interval>(plug_box).to_float();
+    const double phi = Angle::phi_mid<Interval>(plug_box).to_float();
+    const double cos_theta = std::cos(theta);
+    const double sin_theta = std::sin(theta);
+    const double cos_phi = std::cos(phi);
+    const double sin_phi = std::sin(phi);
+    std::vector<VertexMargin> margins;
+    for(const size_t index: vertex_indices) {
+        const Vector3<Interval>& vertex = polyhedron.vertices()[index];
+        const double x = vertex.x().to_float();
+        const double y = vertex.y().to_float();
+        const double z = vertex.z().to_float();
+        const double projected_x = x * cos_theta - y * sin_theta;
+        const double projected_y = (y * cos_theta + x * sin_theta) * cos_phi - z * sin_phi;
+        VertexMargin margin{index, -std::numeric_limits<double>::infinity(), {0, 0, 0}};
+        for(const std::array<double, 3>& half_plane: hole_half_planes) {
+            const auto& [normal_x, normal_y, offset] = half_plane;
+            const double distance = -(normal_x * projected_x + normal_y * projected_y + offset);
+            if(distance > margin.distance) {
+                margin.distance = distance;
+                margin.half_plane = half_plane;
+            }
+        }
+        margins.push_back(margin);
+    }
+    return margins;
+}
+
+// The angle along which the vertex sticking out furthest at the centre of the plug box moves furthest towards the hole
+// within the box, so that halving the box along it tightens the enclosure that decides most. Like the margins it is an
+// estimate in floats, any index gives a valid split.
+template<IntervalType Interval>
+size_t plug_box_split_index(const Polyhedron<Interval>& polyhedron, const std::vector<VertexMargin>& margins, const Box2& plug_box) {
+    if(margins.empty()) {
+        return 0;
+    }
+    const VertexMargin& margin = *std::ranges::max_element(margins, {}, &VertexMargin::distance);
+    const Vector3<Interval>& vertex = polyhedron.vertices()[margin.index];
+    const double x = vertex.x().to_float();
+    const double y = vertex.y().to_float();
+    const double z = vertex.z().to_float();
+    const double theta = Angle::theta_mid<Interval>(plug_box).to_float();
+    const double phi = Angle::phi_mid<Interval>(plug_box).to_float();
+    const double cos_theta = std::cos(theta);
+    const double sin_theta = std::sin(theta);
+    const double cos_phi = std::cos(phi);
+    const double sin_phi = std::sin(phi);
+    const auto& [normal_x, normal_y, offset] = margin.half_plane;
+    // derivatives of the projection along the normal of the half plane
+    const double theta_derivative = normal_x * (-x * sin_theta - y * cos_theta) + normal_y * (x * cos_theta - y * sin_theta) * cos_phi;
+    const double phi_derivative = -normal_y * ((y * cos_theta + x * sin_theta) * sin_phi + z * cos_phi);
+    const double theta_motion = std::abs(theta_derivative) * Angle::theta<Interval>(plug_box).rad().to_float();
+    const double phi_motion = std::abs(phi_derivative) * Angle::phi<Interval>(plug_box).rad().to_float();
+    return phi_motion > theta_motion ? 1 : 0;
+}
+
+// Along one angle at a time, the halves of the plug box that part_outside proves outside the projected hole are added to
+// pruned_plug_boxes, and the plug box shrinks to the other half while only one of them is. An angle is halved to at most
+// one level deeper than the other, so that the boxes that remain stay balanced. Returns what remains of the plug box, or
+// nullopt if none of it does.
+template<typename PartOutside>
+std::optional<Box2> prune_plug_box_halves(const Box2& plug_box, const PartOutside& part_outside, std::vector<Box2>& pruned_plug_boxes) {
+    Box2 remaining_box = plug_box;
+    for(size_t index = 0; index < 2; ++index) {
+        while(remaining_box.range(index).depth() <= remaining_box.range(1 - index).depth()) {
+            const auto [min_part, max_part] = remaining_box.parts(index);
+            const bool min_part_outside = part_outside(min_part);
+            const bool max_part_outside = part_outside(max_part);
+            if(min_part_outside) {
+                pruned_plug_boxes.push_back(min_part);
+            }
+            if(max_part_outside) {
+                pruned_plug_boxes.push_back(max_part);
+            }
+            if(min_part_outside && max_part_outside) {
+                return std::nullopt;
+            }
+            if(!min_part_outside && !max_part_outside) {
+                break;
+            }
+            remaining_box = min_part_outside ? max_part : min_part;
+        }
+    }
+    return remaining_box;
+}
+
+// The projection of a vertex moves by at most the length of the vertex times the angular distance in (theta, phi), so a
+// vertex projecting from the centre of the plug box further outside the hole than that proves the plug box outside.
+// Floats measure how far each vertex projects outside from the centre: vertices projecting inside can not prove anything
+// and are skipped, the others are tried most promising first, through the Lipschitz bound if it suffices and through
+// the edge sweeps otherwise. Vertices that are never on the outline of the plug box project inside the outline, so only
+// the outline candidates of the plug box are measured. Neighbouring plug boxes tend to be proved outside by the same few
+// vertices, so after the most promising candidate the vertices that recently proved a plug box of the same search outside
+// are tried, most recent first. Returns a vertex proving the plug box outside and moves it to the front of
+// recent_vertices, and tried_vertices counts the vertices tested rigorously.
+template<IntervalType Interval>
+std::optional<size_t> plug_box_outside_vertex(const Polyhedron<Interval>& polyhedron, const PlugBoxEnclosures<Interval>& plug_box, const Polygon<Interval>& projected_hole, const std::vector<std::array<double, 3>>& hole_half_planes, MoveToFrontList<size_t>& recent_vertices, BoundaryMemo& memo, size_t& tried_vertices) {
+    const Interval& box_radius = plug_box.angle_box().radius();
+    const double radius = box_radius.to_float();
+    std::vector<std::pair<double, size_t>> candidates;
+    for(const VertexMargin& margin: plug_box_vertex_margins(polyhedron, plug_box.outline_candidate_indices(), hole_half_planes, plug_box.box())) {
+        if(margin.distance > 0) {
+            candidates.emplace_back(margin.distance / (polyhedron.vertex_norms()[margin.index] * radius), margin.index);
+        }
+    }
+    std::ranges::sort(candidates, std::greater());
+    if(candidates.size() > 1) {
+        const std::vector<size_t>& recent = recent_vertices.values();
+        std::ranges::stable_sort(std::next(candidates.begin()), candidates.end(), std::less(), [&](const std::pair<double, size_t>& candidate) {
+            return std::ranges::find(recent, candidate.second) - recent.begin();
+        });
+    }
+    for(const auto& [ratio, index]: candidates) {
+        tried_vertices++;
+        const Vector3<Interval>& vertex = polyhedron.vertices()[index];
+        if(ratio > 1 && projected_hole.beyond_support(plug_box.sample_projection(index), vertex.len() * box_radius)) {
+            recent_vertices.touch(index);
+            return index;
+        }
+        if(projected_oriented_vector_avoids_polygon(projected_hole, index, vertex, plug_box, memo)) {
+            recent_vertices.touch(index);
+            return index;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "queue/queue_type.hpp"
+#include <deque>
+#include <optional>
+#include <mutex>
+#include <vector>
+
+// Tasks are fetched shallowest first, in FIFO or LIFO order within a depth
+template<bool Lifo, BucketTaskType Task>
+class BaseConcurrentBucketQueue {
+    std::vector<std::deque<Task>> buckets_{};
+    size_t min_depth_{0};
+    size_t queued_{0};
+    mutable std::mutex mutex_{};
+    size_t size_{0};
+
+public:
+    explicit BaseConcurrentBucketQueue() = default;
+
+    ~BaseConcurrentBucketQueue() = default;
+
+    BaseConcurrentBucketQueue(const BaseConcurrentBucketQueue& queue) = delete;
+
+    BaseConcurrentBucketQueue(BaseConcurrentBucketQueue&& queue) = delete;
+
+    BaseConcurrentBucketQueue& operator=(const BaseConcurrentBucketQueue&) = delete;
+
+    BaseConcurrentBucketQueue& operator=(BaseConcurrentBucketQueue&&) = delete;
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    void add(const Task& task) {
+        const size_t depth = task.depth();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(depth >= buckets_.size()) {
+            buckets_.resize(depth + 1);
+        }
+        buckets_[depth].push_back(task);
+        min_depth_ = std::min(min_depth_, depth);
+        queued_++;
+        size_++;
+    }
+
+    std::optional<Task> fetch() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(queued_ == 0) {
+            return std::nullopt;
+        }
+        while(buckets_[min_depth_].empty()) {
+            min_depth_++;
+        }
+        std::deque<Task>& bucket = buckets_[min_depth_];
+        queued_--;
+        if constexpr(Lifo) {
+            const Task task = bucket.back();
+            bucket.pop_back();
+            return std::make_optional(task);
+        } else {
+            const Task task = bucket.front();
+            bucket.pop_front();
+            return std::make_optional(task);
+        }
+    }
+
+    void ack() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_--;
+    }
+
+    std::vector<Task> flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Task> tasks;
+        tasks.reserve(queued_);
+        for(std::deque<Task>& bucket: buckets_) {
+            while(!bucket.empty()) {
+                if constexpr(Lifo) {
+                    tasks.push_back(bucket.back());
+                    bucket.pop_back();
+                } else {
+                    tasks.push_back(bucket.front());
+                    bucket.pop_front();
+                }
+                size_--;
+            }
+        }
+        min_depth_ = 0;
+        queued_ = 0;
+        return tasks;
+    }
+};
+
+template<BucketTaskType Task>
+using ConcurrentBucketQueue = BaseConcurrentBucketQueue<false, Task>;
+
+template<BucketTaskType Task>
+using ConcurrentBucketStack = BaseConcurrentBucketQueue<true, Task>;
@@ -25,6 +25,14 @@ concept PriorityTaskType =
         { queue.pop() } -> std::same_as<void>;
     };
 
+template<typename Task>
+concept BucketTaskType =
+    TaskType<Task> &&
+
+    requires(const Task& task) {
+        { task.depth() } -> std::convertible_to<size_t>;
+    };
+
 template<typename Queue, typename Task>
 concept QueueType =
     std::is_default_constructible_v<Queue> &&
@@ -3,3 +3,4 @@
 #include "queue/queue_type.hpp"
 #include "queue/serial_queue.hpp"
 #include "queue/concurrent_queue.hpp"
+#include "queue/bucket_queue.hpp"
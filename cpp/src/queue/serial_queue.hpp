@@ -2,13 +2,23 @@
 
 #include "queue/queue_type.hpp"
 #include <queue>
+#include <stack>
 #include <optional>
+#include <vector>
 
-template<bool Priority, typename Task> requires (Priority ? PriorityTaskType<Task> : TaskType<Task>)
+template<bool Priority, bool Lifo, typename Task> requires (!(Priority && Lifo) && (Priority ? PriorityTaskType<Task> : TaskType<Task>))
 class BaseSerialQueue {
-    std::conditional_t<Priority, std::priority_queue<Task>, std::queue<Task>> queue_{};
+    std::conditional_t<Priority, std::priority_queue<Task>, std::conditional_t<Lifo, std::stack<Task, std::vector<Task>>, std::queue<Task>>> queue_{};
     size_t size_{0};
 
+    const Task& next() const {
+        if constexpr(Priority || Lifo) {
+            return queue_.top();
+        } else {
+            return queue_.front();
+        }
+    }
+
 public:
     explicit BaseSerialQueue() = default;
 
@@ -35,15 +45,9 @@ public:
         if(queue_.empty()) {
             return std::nullopt;
         }
-        if constexpr(Priority) {
-            const Task task = queue_.top();
-            queue_.pop();
-            return std::make_optional(task);
-        } else {
-            const Task task = queue_.front();
-            queue_.pop();
-            return std::make_optional(task);
-        }
+        const Task task = next();
+        queue_.pop();
+        return std::make_optional(task);
     }
 
     void ack() {
@@ -53,13 +57,8 @@ public:
     std::vector<Task> flush() {
         std::vector<Task> tasks;
         while(!queue_.empty()) {
-            if constexpr(Priority) {
-                tasks.push_back(queue_.top());
-                queue_.pop();
-            } else {
-                tasks.push_back(queue_.front());
-                queue_.pop();
-            }
+            tasks.push_back(next());
+            queue_.pop();
         }
         size_ = 0;
         return tasks;
@@ -67,11 +66,16 @@ public:
 };
 
 template<TaskType Task>
-using SerialQueue = BaseSerialQueue<false, Task>;
+using SerialQueue = BaseSerialQueue<false, false, Task>;
 
 static_assert(QueueType<SerialQueue<int>, int>);
 
 template<PriorityTaskType Task>
-using SerialPriorityQueue = BaseSerialQueue<true, Task>;
+using SerialPriorityQueue = BaseSerialQueue<true, false, Task>;
 
 static_assert(QueueType<SerialPriorityQueue<int>, int>);
+
+template<TaskType Task>
+using SerialStack = BaseSerialQueue<false, true, Task>;
+
+static_assert(QueueType<SerialStack<int>, int>);
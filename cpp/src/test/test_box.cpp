@@ -0,0 +1,47 @@
+#include "box/boxes.hpp"
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("range") {
+    SECTION("parts are halves") {
+        const auto [min_part, max_part] = Range(Bitset(3, 0b100)).parts();
+        REQUIRE(min_part.pack() == (1 << 4 | 0b1000));
+        REQUIRE(max_part.pack() == (1 << 4 | 0b1001));
+    }
+}
+
+TEST_CASE("box") {
+    SECTION("parts along one range") {
+        const Box2 box(std::array{Range(Bitset(1, 1)), Range(Bitset(2, 0b10))});
+        const auto [min_part, max_part] = box.parts(0);
+        REQUIRE(min_part.range(0).pack() == (1 << 2 | 0b10));
+        REQUIRE(max_part.range(0).pack() == (1 << 2 | 0b11));
+        REQUIRE(min_part.range(1).pack() == box.range(1).pack());
+        REQUIRE(max_part.range(1).pack() == box.range(1).pack());
+    }
+}
+
+static bool encloses(const BoostInterval& interval, const BoostInterval& other_interval) {
+    const auto [interval_min, interval_max] = interval.to_floats();
+    const auto [other_interval_min, other_interval_max] = other_interval.to_floats();
+    return interval_min <= other_interval_min && other_interval_max <= interval_max;
+}
+
+TEST_CASE("angle range") {
+    SECTION("ends enclose the exact end angles") {
+        for(const Range& range: {Range(Bitset(0, 0)), Range(Bitset(1, 1)), Range(Bitset(2, 0b01)), Range(Bitset(3, 0b011)), Range(Bitset(5, 0b10111))}) {
+            const AngleRange<BoostInterval> angle_range(range);
+            REQUIRE(encloses(angle_range.min().angle(), Angle::angle_min<BoostInterval>(range)));
+            REQUIRE(encloses(angle_range.max().angle(), Angle::angle_max<BoostInterval>(range)));
+        }
+    }
+
+    SECTION("neighbours of different depths share their common end") {
+        const Range range(Bitset(2, 0b01));
+        const Range next_range(Bitset(3, 0b100));
+        REQUIRE(range.max_key() == next_range.min_key());
+        const AngleRange<BoostInterval> angle_range(range);
+        const AngleRange<BoostInterval> next_angle_range(next_range);
+        REQUIRE(angle_range.max().angle().to_floats() == next_angle_range.min().angle().to_floats());
+        REQUIRE(angle_range.max().cos().to_floats() == next_angle_range.min().cos().to_floats());
+    }
+}
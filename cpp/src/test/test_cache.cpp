@@ -0,0 +1,171 @@
+#include "cache/concurrent_cache.hpp"
+#include "cache/boundary_memo.hpp"
+#include "cache/published_table.hpp"
+#include "cache/move_to_front_list.hpp"
+#include "box/range.hpp"
+#include <catch2/catch_all.hpp>
+#include <thread>
+#include <vector>
+
+// spreads keys over the shards by their value, so that tests know which keys share a shard
+struct IdentityHash {
+    size_t operator()(const uint64_t key) const {
+        return static_cast<size_t>(key);
+    }
+};
+
+TEST_CASE("concurrent cache") {
+    SECTION("miss then hit") {
+        ConcurrentCache<uint64_t, int> cache(64);
+        REQUIRE_FALSE(cache.get(1).has_value());
+        cache.put(1, 10);
+        REQUIRE(cache.get(1) == 10);
+        REQUIRE(cache.hits() == 1);
+        REQUIRE(cache.misses() == 1);
+    }
+
+    SECTION("first value wins") {
+        ConcurrentCache<uint64_t, int> cache(64);
+        cache.put(1, 10);
+        cache.put(1, 20);
+        REQUIRE(cache.get_or_compute(1, [] { return 30; }) == 10);
+    }
+
+    SECTION("oldest entry is evicted") {
+        // a capacity of 16 leaves one entry per shard, and keys 0 and 16 share a shard
+        ConcurrentCache<uint64_t, int, IdentityHash> cache(16);
+        cache.put(0, 0);
+        cache.put(16, 16);
+        REQUIRE_FALSE(cache.get(0).has_value());
+        REQUIRE(cache.get(16) == 16);
+    }
+
+    SECTION("shared between threads") {
+        ConcurrentCache<uint64_t, uint64_t> cache(1024);
+        std::vector<std::vector<uint64_t>> values(4);
+        std::vector<std::thread> threads;
+        for(std::vector<uint64_t>& thread_values: values) {
+            threads.emplace_back([&cache, &thread_values] {
+                for(uint64_t key = 0; key < 256; ++key) {
+                    thread_values.push_back(cache.get_or_compute(key, [key] { return key * key; }));
+                }
+            });
+        }
+        for(std::thread& thread: threads) {
+            thread.join();
+        }
+        for(const std::vector<uint64_t>& thread_values: values) {
+            for(uint64_t key = 0; key < 256; ++key) {
+                REQUIRE(thread_values[key] == key * key);
+            }
+        }
+        REQUIRE(cache.hits() + cache.misses() == 4 * 256);
+    }
+}
+
+TEST_CASE("boundary memo") {
+    SECTION("neighbouring ranges share their common end") {
+        const auto [min_part, max_part] = Range(Bitset(2, 1)).parts();
+        REQUIRE(min_part.max_key() == max_part.min_key());
+        REQUIRE(min_part.min_key() == Range(Bitset(2, 1)).min_key());
+        REQUIRE(max_part.max_key() == Range(Bitset(2, 1)).max_key());
+        REQUIRE(Range(Bitset(0, 0)).max_key() == uint32_t{1} << range_depth_limit);
+    }
+
+    SECTION("corners and edges have distinct keys") {
+        const Range range(Bitset(3, 5));
+        REQUIRE_FALSE(BoundaryKey::corner(0, range.min_key(), range.pack()) == BoundaryKey::fixed_theta(0, range.min_key(), range.pack()));
+        REQUIRE_FALSE(BoundaryKey::fixed_theta(0, range.pack(), range.pack()) == BoundaryKey::fixed_phi(0, range.pack(), range.pack()));
+    }
+
+    SECTION("each test is computed once") {
+        BoundaryMemo memo(64);
+        size_t computed = 0;
+        const auto compute = [&computed] {
+            computed++;
+            return true;
+        };
+        REQUIRE(memo.get_or_compute(BoundaryKey::corner(1, 2, 3), compute));
+        REQUIRE(memo.get_or_compute(BoundaryKey::corner(1, 2, 3), compute));
+        REQUIRE(memo.get_or_compute(BoundaryKey::corner(2, 2, 3), compute));
+        REQUIRE(computed == 2);
+        REQUIRE(memo.hits() == 1);
+        REQUIRE(memo.misses() == 2);
+    }
+
+    SECTION("full memo starts over") {
+        BoundaryMemo memo(2);
+        memo.get_or_compute(BoundaryKey::corner(0, 0, 0), [] { return false; });
+        memo.get_or_compute(BoundaryKey::corner(1, 0, 0), [] { return false; });
+        memo.get_or_compute(BoundaryKey::corner(2, 0, 0), [] { return true; });
+        REQUIRE_FALSE(memo.get(BoundaryKey::corner(0, 0, 0)).has_value());
+        REQUIRE(memo.get(BoundaryKey::corner(2, 0, 0)) == true);
+    }
+}
+
+TEST_CASE("move to front list") {
+    SECTION("touched values come first") {
+        MoveToFrontList<size_t> list(3);
+        list.touch(1);
+        list.touch(2);
+        list.touch(3);
+        REQUIRE(list.values() == std::vector<size_t>{3, 2, 1});
+        list.touch(1);
+        REQUIRE(list.values() == std::vector<size_t>{1, 3, 2});
+        list.touch(1);
+        REQUIRE(list.values() == std::vector<size_t>{1, 3, 2});
+    }
+
+    SECTION("full list drops the least recently touched value") {
+        MoveToFrontList<size_t> list(2);
+        list.touch(1);
+        list.touch(2);
+        list.touch(3);
+        REQUIRE(list.values() == std::vector<size_t>{3, 2});
+    }
+
+    SECTION("empty list keeps nothing") {
+        MoveToFrontList<size_t> list(0);
+        list.touch(1);
+        REQUIRE(list.values().empty());
+    }
+}
+
+TEST_CASE("published table") {
+    SECTION("value is computed once") {
+        PublishedTable<int> table(4);
+        REQUIRE(table.get(1) == nullptr);
+        int computed = 0;
+        const auto compute = [&computed] {
+            computed++;
+            return std::make_unique<const int>(10);
+        };
+        REQUIRE(table.get_or_publish(1, compute) == 10);
+        REQUIRE(table.get_or_publish(1, compute) == 10);
+        REQUIRE(computed == 1);
+        REQUIRE(*table.get(1) == 10);
+        REQUIRE(table.get(0) == nullptr);
+    }
+
+    SECTION("all threads see the published value") {
+        PublishedTable<uint64_t> table(256);
+        std::vector<std::vector<const uint64_t*>> values(4);
+        std::vector<std::thread> threads;
+        for(std::vector<const uint64_t*>& thread_values: values) {
+            threads.emplace_back([&table, &thread_values] {
+                for(uint64_t index = 0; index < 256; ++index) {
+                    thread_values.push_back(&table.get_or_publish(index, [index] { return std::make_unique<const uint64_t>(index * index); }));
+                }
+            });
+        }
+        for(std::thread& thread: threads) {
+            thread.join();
+        }
+        for(uint64_t index = 0; index < 256; ++index) {
+            REQUIRE(*table.get(index) == index * index);
+            for(const std::vector<const uint64_t*>& thread_values: values) {
+                REQUIRE(thread_values[index] == table.get(index));
+            }
+        }
+    }
+}
@@ -0,0 +1,385 @@
+#include "global_solver/helpers.hpp"
+#include <catch2/catch_all.hpp>
+
+using HelperInterval = BoostInterval;
+
+// projection of the vertex at the orientation in floats
+static std::pair<double, double> float_projection(const Vector3<HelperInterval>& vertex, const double theta, const double phi) {
+    const double x = vertex.x().to_float();
+    const double y = vertex.y().to_float();
+    const double z = vertex.z().to_float();
+    return std::pair(x * std::cos(theta) - y * std::sin(theta), (y * std::cos(theta) + x * std::sin(theta)) * std::cos(phi) - z * std::sin(phi));
+}
+
+// whether some vertex projects outside the half planes of the hole at the orientation in floats
+static bool sticks_out(const Polyhedron<HelperInterval>& polyhedron, const std::vector<std::array<double, 3>>& hole_half_planes, const double theta, const double phi) {
+    for(const Vector3<HelperInterval>& vertex: polyhedron.vertices()) {
+        const auto [projected_x, projected_y] = float_projection(vertex, theta, phi);
+        for(const auto& [normal_x, normal_y, offset]: hole_half_planes) {
+            if(normal_x * projected_x + normal_y * projected_y + offset < 1e-9) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool contains(const HelperInterval& interval, const double value) {
+    const auto [min, max] = interval.to_floats();
+    return min - 1e-12 <= value && value <= max + 1e-12;
+}
+
+// orientations on a grid over the ranges of theta and phi, including their ends
+static std::vector<std::pair<double, double>> sample_orientations(const Range& theta_range, const Range& phi_range) {
+    const double theta_min = Angle::angle_min<HelperInterval>(theta_range).to_float();
+    const double theta_max = Angle::angle_max<HelperInterval>(theta_range).to_float();
+    const double phi_min = Angle::angle_min<HelperInterval>(phi_range).to_float();
+    const double phi_max = Angle::angle_max<HelperInterval>(phi_range).to_float();
+    std::vector<std::pair<double, double>> orientations;
+    for(int i = 0; i <= 4; ++i) {
+        for(int j = 0; j <= 4; ++j) {
+            orientations.emplace_back(theta_min + (theta_max - theta_min) * i / 4, phi_min + (phi_max - phi_min) * j / 4);
+        }
+    }
+    return orientations;
+}
+
+static std::vector<std::pair<double, double>> sample_orientations(const Box2& box) {
+    return sample_orientations(Angle::theta_range(box), Angle::phi_range(box));
+}
+
+// vertices at the corners of the convex hull of the projection at the orientation in floats, leaving out those at
+// corners too flat to tell
+static std::vector<size_t> float_silhouette(const std::vector<Vector3<HelperInterval>>& vertices, const double theta, const double phi) {
+    std::vector<std::pair<std::pair<double, double>, size_t>> points;
+    for(size_t index = 0; index < vertices.size(); ++index) {
+        points.emplace_back(float_projection(vertices[index], theta, phi), index);
+    }
+    std::ranges::sort(points);
+    const auto turn = [](const auto& point_0, const auto& point_1, const auto& point_2) {
+        const auto& [x_0, y_0] = point_0.first;
+        const auto& [x_1, y_1] = point_1.first;
+        const auto& [x_2, y_2] = point_2.first;
+        return (x_1 - x_0) * (y_2 - y_0) - (y_1 - y_0) * (x_2 - x_0);
+    };
+    std::vector<size_t> silhouette;
+    for(const bool upper: {false, true}) {
+        std::vector<std::pair<std::pair<double, double>, size_t>> chain;
+        for(size_t i = 0; i < points.size(); ++i) {
+            const auto& point = points[upper ? points.size() - 1 - i : i];
+            while(chain.size() >= 2 && turn(chain[chain.size() - 2], chain.back(), point) <= 1e-9) {
+                chain.pop_back();
+            }
+            chain.push_back(point);
+        }
+        for(const auto& point: chain) {
+            silhouette.push_back(point.second);
+        }
+    }
+    return silhouette;
+}
+
+static bool includes(const std::vector<size_t>& indices, const std::vector<size_t>& other_indices) {
+    return std::ranges::all_of(other_indices, [&](const size_t index) {
+        return std::ranges::find(indices, index) != indices.end();
+    });
+}
+
+// smallest signed distance of the projection of the vertex to the half planes of the hole, negative outside
+static double float_depth(const std::vector<std::array<double, 3>>& hole_half_planes, const Vector3<HelperInterval>& vertex, const double theta, const double phi) {
+    const auto [projected_x, projected_y] = float_projection(vertex, theta, phi);
+    double depth = std::numeric_limits<double>::infinity();
+    for(const auto& [normal_x, normal_y, offset]: hole_half_planes) {
+        depth = std::min(depth, normal_x * projected_x + normal_y * projected_y + offset);
+    }
+    return depth;
+}
+
+TEST_CASE("support function prefilter") {
+    const Polyhedron<HelperInterval> polyhedron(Archimedean::rhombicosidodecahedron<HelperInterval>());
+
+    struct Decision {
+        bool outside;
+        double min_depth;
+        double max_depth;
+    };
+    std::vector<Decision> decisions;
+    // the hole of the wide hole box is swept over a wide range of alpha, so that its inscribed circle holds the vertices
+    for(const Box3& hole_box: {
+            Box3(std::array{Range(Bitset(4, 1)), Range(Bitset(4, 3)), Range(Bitset(4, 2))}),
+            Box3(std::array{Range(Bitset(8, 13)), Range(Bitset(8, 37)), Range(Bitset(8, 22))})
+        }) {
+        const Polygon<HelperInterval> projected_hole = project_polyhedron(polyhedron, all_vertex_indices(polyhedron), hole_box, 1);
+        const std::vector<std::array<double, 3>> hole_half_planes = float_half_planes(projected_hole);
+        for(size_t theta_bits = 0; theta_bits < 64; theta_bits += 5) {
+            for(size_t phi_bits = 0; phi_bits < 64; phi_bits += 5) {
+                const Range theta_range(Bitset(6, theta_bits));
+                const Range phi_range(Bitset(6, phi_bits));
+                const AngleRange<HelperInterval> theta(theta_range);
+                const AngleRange<HelperInterval> phi(phi_range);
+                for(const Vector3<HelperInterval>& vertex: polyhedron.vertices()) {
+                    const Vector2<HelperInterval> projected_box = combined_projected_box(vertex, theta.value().angle(), phi.value().angle());
+                    const std::optional<bool> outside = projected_oriented_vector_avoids_polygon_without_boundary(projected_hole, vertex, projected_box, theta, phi);
+                    if(!outside.has_value()) {
+                        continue;
+                    }
+                    double min_depth = std::numeric_limits<double>::infinity();
+                    double max_depth = -std::numeric_limits<double>::infinity();
+                    for(const auto& [sample_theta, sample_phi]: sample_orientations(theta_range, phi_range)) {
+                        const double depth = float_depth(hole_half_planes, vertex, sample_theta, sample_phi);
+                        min_depth = std::min(min_depth, depth);
+                        max_depth = std::max(max_depth, depth);
+                    }
+                    decisions.push_back(Decision{outside.value(), min_depth, max_depth});
+                }
+            }
+        }
+    }
+
+    SECTION("vertices decided outside project outside at every sampled orientation") {
+        REQUIRE(std::ranges::count_if(decisions, &Decision::outside) > 0);
+        for(const Decision& decision: decisions) {
+            if(decision.outside) {
+                REQUIRE(decision.max_depth < 1e-9);
+            }
+        }
+    }
+
+    SECTION("vertices decided unable to leave the hole project inside at every sampled orientation") {
+        REQUIRE(std::ranges::count_if(decisions, &Decision::outside) < static_cast<std::ptrdiff_t>(decisions.size()));
+        for(const Decision& decision: decisions) {
+            if(!decision.outside) {
+                REQUIRE(decision.min_depth > -1e-9);
+            }
+        }
+    }
+}
+
+TEST_CASE("plug box halves") {
+    const Polyhedron<HelperInterval> cube(Platonic::cube<HelperInterval>());
+    const Box3 hole_box(std::array{Range(Bitset(4, 1)), Range(Bitset(4, 3)), Range(Bitset(4, 2))});
+    const Polygon<HelperInterval> projected_hole = project_polyhedron(cube, all_vertex_indices(cube), hole_box, 1);
+    const std::vector<std::array<double, 3>> hole_half_planes = float_half_planes(projected_hole);
+    BoundaryMemo memo(1 << 10);
+    const auto part_outside = [&](const Box2& part) {
+        const PlugBoxEnclosures<HelperInterval> plug_box(cube, AngleBox<HelperInterval, 2>(part));
+        MoveToFrontList<size_t> recent_vertices(4);
+        size_t tried_vertices = 0;
+        return plug_box_outside_vertex(cube, plug_box, projected_hole, hole_half_planes, recent_vertices, memo, tried_vertices).has_value();
+    };
+
+    struct Halving {
+        Box2 plug_box;
+        std::optional<Box2> remaining_box;
+        std::vector<Box2> pruned_plug_boxes;
+    };
+    std::vector<Halving> halvings;
+    for(size_t theta_bits = 0; theta_bits < 8; ++theta_bits) {
+        for(size_t phi_bits = 0; phi_bits < 8; ++phi_bits) {
+            const Box2 plug_box(std::array{Range(Bitset(3, theta_bits)), Range(Bitset(3, phi_bits))});
+            std::vector<Box2> pruned_plug_boxes;
+            const std::optional<Box2> remaining_box = prune_plug_box_halves(plug_box, part_outside, pruned_plug_boxes);
+            halvings.push_back(Halving{plug_box, remaining_box, pruned_plug_boxes});
+        }
+    }
+
+    SECTION("pruned halves lie outside the hole") {
+        for(const Halving& halving: halvings) {
+            for(const Box2& pruned_plug_box: halving.pruned_plug_boxes) {
+                for(const auto& [theta, phi]: sample_orientations(pruned_plug_box)) {
+                    REQUIRE(sticks_out(cube, hole_half_planes, theta, phi));
+                }
+            }
+        }
+    }
+
+    SECTION("plug boxes shrink to the balanced rest") {
+        size_t shrunk_count = 0;
+        for(const auto& [plug_box, remaining_box, pruned_plug_boxes]: halvings) {
+            size_t pruned_depth = plug_box.depth();
+            for(const Box2& pruned_plug_box: pruned_plug_boxes) {
+                REQUIRE(pruned_plug_box.depth() > plug_box.depth());
+                pruned_depth = std::max(pruned_depth, pruned_plug_box.depth());
+            }
+            if(!remaining_box.has_value()) {
+                continue;
+            }
+            REQUIRE(remaining_box->depth() == pruned_depth);
+            REQUIRE(remaining_box->range(0).depth() <= remaining_box->range(1).depth() + 1);
+            REQUIRE(remaining_box->range(1).depth() <= remaining_box->range(0).depth() + 1);
+            if(!pruned_plug_boxes.empty()) {
+                shrunk_count++;
+            }
+        }
+        REQUIRE(shrunk_count > 0);
+    }
+}
+
+TEST_CASE("recent proving vertices") {
+    const Polyhedron<HelperInterval> cube(Platonic::cube<HelperInterval>());
+    const Box3 hole_box(std::array{Range(Bitset(4, 1)), Range(Bitset(4, 3)), Range(Bitset(4, 2))});
+    const Polygon<HelperInterval> projected_hole = project_polyhedron(cube, all_vertex_indices(cube), hole_box, 1);
+    const std::vector<std::array<double, 3>> hole_half_planes = float_half_planes(projected_hole);
+    BoundaryMemo memo(1 << 10);
+    MoveToFrontList<size_t> recent_vertices(4);
+
+    struct Outcome {
+        std::optional<size_t> vertex;
+        std::optional<size_t> fresh_vertex;
+        std::vector<size_t> recent;
+    };
+    std::vector<Outcome> outcomes;
+    for(size_t theta_bits = 0; theta_bits < 16; ++theta_bits) {
+        for(size_t phi_bits = 0; phi_bits < 16; ++phi_bits) {
+            const Box2 box(std::array{Range(Bitset(4, theta_bits)), Range(Bitset(4, phi_bits))});
+            const PlugBoxEnclosures<HelperInterval> plug_box(cube, AngleBox<HelperInterval, 2>(box));
+            MoveToFrontList<size_t> fresh_vertices(4);
+            size_t tried_vertices = 0;
+            const std::optional<size_t> vertex = plug_box_outside_vertex(cube, plug_box, projected_hole, hole_half_planes, recent_vertices, memo, tried_vertices);
+            const std::optional<size_t> fresh_vertex = plug_box_outside_vertex(cube, plug_box, projected_hole, hole_half_planes, fresh_vertices, memo, tried_vertices);
+            outcomes.push_back(Outcome{vertex, fresh_vertex, recent_vertices.values()});
+        }
+    }
+
+    SECTION("the order of the candidates does not change which plug boxes are outside") {
+        for(const Outcome& outcome: outcomes) {
+            REQUIRE(outcome.vertex.has_value() == outcome.fresh_vertex.has_value());
+        }
+        REQUIRE(std::ranges::count_if(outcomes, [](const Outcome& outcome) { return outcome.vertex.has_value(); }) > 0);
+    }
+
+    SECTION("the proving vertex moves to the front") {
+        for(const Outcome& outcome: outcomes) {
+            if(outcome.vertex.has_value()) {
+                REQUIRE(outcome.recent.front() == outcome.vertex.value());
+            }
+            REQUIRE(outcome.recent.size() <= 4);
+        }
+    }
+}
+
+TEST_CASE("centred box") {
+    const std::vector<Vector3<HelperInterval>> vertices = Archimedean::rhombicosidodecahedron<HelperInterval>();
+    const std::vector<Box2> plug_boxes = {
+        Box2(std::array{Range(Bitset(2, 1)), Range(Bitset(2, 2))}),
+        Box2(std::array{Range(Bitset(5, 7)), Range(Bitset(4, 9))}),
+        Box2(std::array{Range(Bitset(9, 300)), Range(Bitset(9, 170))})
+    };
+
+    SECTION("encloses the trajectories of the vertices") {
+        for(const Box2& plug_box: plug_boxes) {
+            const AngleBox<HelperInterval, 2> angle_box(plug_box);
+            for(const Vector3<HelperInterval>& vertex: vertices) {
+                const Vector2<HelperInterval> box = centred_box(vertex, angle_box.theta(), angle_box.phi());
+                for(const auto& [theta, phi]: sample_orientations(plug_box)) {
+                    const auto [projected_x, projected_y] = float_projection(vertex, theta, phi);
+                    REQUIRE(contains(box.x(), projected_x));
+                    REQUIRE(contains(box.y(), projected_y));
+                }
+            }
+        }
+    }
+
+    SECTION("is tighter than the natural enclosure on small boxes") {
+        const AngleBox<HelperInterval, 2> angle_box(plug_boxes.back());
+        double size = 0;
+        double natural_size = 0;
+        for(const Vector3<HelperInterval>& vertex: vertices) {
+            const Vector2<HelperInterval> box = centred_box(vertex, angle_box.theta(), angle_box.phi());
+            const Vector2<HelperInterval> natural_box = trivial_box(vertex, angle_box.theta().value(), angle_box.phi().value());
+            REQUIRE(box.x().len().to_float() <= natural_box.x().len().to_float());
+            REQUIRE(box.y().len().to_float() <= natural_box.y().len().to_float());
+            size += box.x().len().to_float() + box.y().len().to_float();
+            natural_size += natural_box.x().len().to_float() + natural_box.y().len().to_float();
+        }
+        REQUIRE(size < 0.9 * natural_size);
+    }
+}
+
+TEST_CASE("silhouette vertices") {
+    const Polyhedron<HelperInterval> polyhedron(Archimedean::rhombicosidodecahedron<HelperInterval>());
+
+    SECTION("hole boxes keep every vertex of the silhouettes inside them, carried from their parents") {
+        for(size_t theta_bits = 0; theta_bits < 8; ++theta_bits) {
+            for(size_t phi_bits = 0; phi_bits < 4; ++phi_bits) {
+                const Box3 parent_box(std::array{Range(Bitset(3, theta_bits)), Range(Bitset(3, phi_bits)), Range(Bitset(1, 0))});
+                const std::vector<size_t> parent_indices = silhouette_vertex_indices(polyhedron, AngleBox<HelperInterval, 3>(parent_box), all_vertex_indices(polyhedron));
+                for(const Box3& box: parent_box.parts()) {
+                    const std::vector<size_t> indices = silhouette_vertex_indices(polyhedron, AngleBox<HelperInterval, 3>(box), parent_indices);
+                    REQUIRE(includes(parent_indices, indices));
+                    for(const auto& [theta, phi]: sample_orientations(Angle::theta_range(box), Angle::phi_range(box))) {
+                        REQUIRE(includes(indices, float_silhouette(polyhedron.vertices(), theta, phi)));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("small hole boxes leave out the vertices inside the outline") {
+        const Box3 box(std::array{Range(Bitset(8, 37)), Range(Bitset(8, 21)), Range(Bitset(1, 0))});
+        REQUIRE(silhouette_vertex_indices(polyhedron, AngleBox<HelperInterval, 3>(box), all_vertex_indices(polyhedron)).size() < polyhedron.vertices().size() / 2);
+    }
+
+    SECTION("hole boxes seeing a single outline keep exactly its vertices") {
+        size_t outline_count = 0;
+        for(size_t theta_bits = 0; theta_bits < 128; theta_bits += 3) {
+            for(size_t phi_bits = 0; phi_bits < 64; phi_bits += 3) {
+                const Box3 box(std::array{Range(Bitset(7, theta_bits)), Range(Bitset(7, phi_bits)), Range(Bitset(1, 0))});
+                const AngleBox<HelperInterval, 3> angle_box(box);
+                const Matrix<HelperInterval> matrix = Matrix<HelperInterval>::rotation_x(angle_box.phi().value().cos(), angle_box.phi().value().sin()) *
+                                                      Matrix<HelperInterval>::rotation_z(angle_box.theta().value().cos(), angle_box.theta().value().sin());
+                const Vector3<HelperInterval> direction = matrix.transpose() * Vector3<HelperInterval>(HelperInterval(0), HelperInterval(0), HelperInterval(1));
+                const std::optional<size_t> outline_index = polyhedron.find_outline(polyhedron.get_normal_mask(direction));
+                if(!outline_index.has_value()) {
+                    continue;
+                }
+                outline_count++;
+                std::vector<size_t> indices = silhouette_vertex_indices(polyhedron, angle_box, all_vertex_indices(polyhedron));
+                std::vector<size_t> outline_indices = polyhedron.outlines()[outline_index.value()].vertex_indices;
+                std::ranges::sort(indices);
+                std::ranges::sort(outline_indices);
+                REQUIRE(indices == outline_indices);
+                for(const auto& [theta, phi]: sample_orientations(Angle::theta_range(box), Angle::phi_range(box))) {
+                    REQUIRE(includes(indices, float_silhouette(polyhedron.vertices(), theta, phi)));
+                }
+            }
+        }
+        REQUIRE(outline_count > 0);
+    }
+}
+
+TEST_CASE("plug outline vertices") {
+    const Polyhedron<HelperInterval> polyhedron(Archimedean::rhombicosidodecahedron<HelperInterval>());
+    std::vector<Box2> plug_boxes;
+    for(const size_t depth: {2, 4, 6}) {
+        for(size_t theta_bits = 0; theta_bits < size_t{1} << depth; theta_bits += depth - 1) {
+            for(size_t phi_bits = 0; phi_bits < size_t{1} << depth; phi_bits += depth - 1) {
+                plug_boxes.emplace_back(std::array{Range(Bitset(depth, theta_bits)), Range(Bitset(depth, phi_bits))});
+            }
+        }
+    }
+
+    SECTION("candidates hold every vertex of the silhouettes inside the plug box") {
+        for(const Box2& plug_box: plug_boxes) {
+            const std::vector<size_t> indices = plug_outline_candidate_indices(polyhedron, AngleBox<HelperInterval, 2>(plug_box));
+            for(const auto& [theta, phi]: sample_orientations(plug_box)) {
+                REQUIRE(includes(indices, float_silhouette(polyhedron.vertices(), theta, phi)));
+            }
+        }
+    }
+
+    SECTION("sample outlines hold every vertex of the silhouette at the centre of the plug box") {
+        for(const Box2& plug_box: plug_boxes) {
+            const std::vector<size_t> indices = plug_sample_outline_indices(polyhedron, AngleBox<HelperInterval, 2>(plug_box));
+            const double theta = Angle::theta_mid<HelperInterval>(plug_box).to_float();
+            const double phi = Angle::phi_mid<HelperInterval>(plug_box).to_float();
+            REQUIRE(includes(indices, float_silhouette(polyhedron.vertices(), theta, phi)));
+        }
+    }
+
+    SECTION("small plug boxes narrow the candidates down") {
+        const Box2 plug_box(std::array{Range(Bitset(8, 37)), Range(Bitset(8, 21))});
+        REQUIRE(plug_outline_candidate_indices(polyhedron, AngleBox<HelperInterval, 2>(plug_box)).size() < polyhedron.vertices().size() / 2);
+        REQUIRE(plug_sample_outline_indices(polyhedron, AngleBox<HelperInterval, 2>(plug_box)).size() < polyhedron.vertices().size() / 2);
+    }
+}
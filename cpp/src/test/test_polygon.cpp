@@ -0,0 +1,101 @@
+#include "geometry/geometry.hpp"
+#include <catch2/catch_all.hpp>
+
+using PolygonInterval = BoostInterval;
+
+static Vector2<PolygonInterval> point(const PolygonInterval& x, const PolygonInterval& y) {
+    return Vector2<PolygonInterval>(x, y);
+}
+
+static Polygon<PolygonInterval> polygon(const std::vector<Vector2<PolygonInterval>>& vertices, const bool centrally_symmetric) {
+    std::vector<Edge<PolygonInterval>> edges;
+    for(size_t i = 0; i < vertices.size(); ++i) {
+        edges.emplace_back(vertices[i], vertices[(i + 1) % vertices.size()]);
+    }
+    return Polygon<PolygonInterval>(edges, centrally_symmetric);
+}
+
+TEST_CASE("polygon") {
+    const PolygonInterval one(1);
+    const PolygonInterval tiny = one / PolygonInterval(100000) / PolygonInterval(100000);
+
+    SECTION("inside a nearly symmetric polygon is tested against every edge") {
+        // the right edge is paired with the left edge, which it lies a little further out than
+        const PolygonInterval right = one + tiny * PolygonInterval(5);
+        for(const bool centrally_symmetric: {false, true}) {
+            const Polygon<PolygonInterval> square = polygon({point(right, -one), point(right, one), point(-one, one), point(-one, -one)}, centrally_symmetric);
+            REQUIRE_FALSE(square.inside(point(-one - tiny, PolygonInterval(0))));
+            REQUIRE(square.inside(point(one + tiny, PolygonInterval(0))));
+            REQUIRE(square.inside(point(PolygonInterval(0), PolygonInterval(0))));
+        }
+    }
+
+    // the edges have normals (1, 3) and its reflections, which are not among the directions of the coarse outer polygon
+    const PolygonInterval three(3);
+    const std::vector<Vector2<PolygonInterval>> diamond_vertices = {point(three, PolygonInterval(0)), point(PolygonInterval(0), one), point(-three, PolygonInterval(0)), point(PolygonInterval(0), -one)};
+    const Polygon<PolygonInterval> diamond = polygon(diamond_vertices, true);
+    const Polygon<PolygonInterval> asymmetric_diamond = polygon(diamond_vertices, false);
+    // beyond the edge from (3, 0) to (0, 1) by 0.3 / sqrt(10), about 0.095, but inside the coarse outer polygon
+    const Vector2<PolygonInterval> near_edge = point(three / PolygonInterval(2), three / PolygonInterval(5));
+    const Vector2<PolygonInterval> above = point(PolygonInterval(0), PolygonInterval(2));
+
+    SECTION("the coarse outer polygon contains the polygon") {
+        for(const Vector2<PolygonInterval>& vertex: diamond_vertices) {
+            REQUIRE_FALSE(diamond.beyond_coarse_support(vertex));
+            REQUIRE_FALSE(diamond.beyond_coarse_support(-vertex));
+        }
+        REQUIRE_FALSE(diamond.beyond_coarse_support(near_edge));
+        REQUIRE(diamond.beyond_support(near_edge));
+        REQUIRE(diamond.beyond_coarse_support(above));
+        REQUIRE(diamond.beyond_coarse_support(-above));
+    }
+
+    SECTION("margins widen the polygon") {
+        REQUIRE(diamond.beyond_coarse_support(above, one / PolygonInterval(2)));
+        REQUIRE_FALSE(diamond.beyond_coarse_support(above, one));
+        REQUIRE(diamond.beyond_support(above, one / PolygonInterval(2)));
+        REQUIRE_FALSE(diamond.beyond_support(above, one));
+        REQUIRE(diamond.beyond_support(near_edge, one / PolygonInterval(20)));
+        REQUIRE_FALSE(diamond.beyond_support(near_edge, one / PolygonInterval(10)));
+        REQUIRE(diamond.beyond_support(-near_edge, one / PolygonInterval(20)));
+        REQUIRE_FALSE(diamond.beyond_support(-near_edge, one / PolygonInterval(10)));
+    }
+
+    SECTION("outside a symmetric polygon is tested against the reflections of the edges") {
+        for(const Polygon<PolygonInterval>* tested: {&diamond, &asymmetric_diamond}) {
+            REQUIRE(tested->outside(near_edge));
+            REQUIRE(tested->outside(-near_edge));
+            REQUIRE(tested->outside(above));
+            REQUIRE_FALSE(tested->outside(point(three / PolygonInterval(2), PolygonInterval(9) / PolygonInterval(20))));
+            REQUIRE_FALSE(tested->outside(point(PolygonInterval(0), PolygonInterval(0))));
+        }
+    }
+
+    SECTION("polygons without a promised symmetry build their support function on demand") {
+        for(const Vector2<PolygonInterval>& vector: {near_edge, -near_edge, above, point(one, PolygonInterval(0))}) {
+            REQUIRE(asymmetric_diamond.beyond_support(vector) == diamond.beyond_support(vector));
+            REQUIRE(asymmetric_diamond.beyond_coarse_support(vector) == diamond.beyond_coarse_support(vector));
+            REQUIRE(asymmetric_diamond.beyond_support(vector, one / PolygonInterval(20)) == diamond.beyond_support(vector, one / PolygonInterval(20)));
+        }
+    }
+
+    SECTION("the circles around the origin bound the polygon") {
+        for(const Polygon<PolygonInterval>* tested: {&diamond, &asymmetric_diamond}) {
+            // the farthest corner is at distance 3, the edges at 3 / sqrt(10), about 0.949
+            REQUIRE_FALSE(tested->circumradius() < three);
+            REQUIRE(tested->circumradius() < three + tiny);
+            REQUIRE(tested->inradius() < PolygonInterval(95) / PolygonInterval(100));
+            REQUIRE(PolygonInterval(94) / PolygonInterval(100) < tested->inradius());
+        }
+        const Polygon<PolygonInterval> shifted = polygon({point(one, one), point(three, one), point(three, three), point(one, three)}, false);
+        REQUIRE_FALSE(shifted.inradius().nonz());
+    }
+
+    SECTION("points on the supporting lines are not beyond them") {
+        for(const Vector2<PolygonInterval>& vertex: diamond_vertices) {
+            REQUIRE_FALSE(diamond.beyond_support(vertex));
+        }
+        REQUIRE(diamond.beyond_support(point(three + tiny, PolygonInterval(0))));
+        REQUIRE(diamond.beyond_support(point(-three - tiny, PolygonInterval(0))));
+    }
+}
@@ -0,0 +1,211 @@
+#include "geometry/geometry.hpp"
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+
+using CacheInterval = BoostInterval;
+
+static std::vector<uint32_t> read_words(const std::filesystem::path& path) {
+    std::vector<uint32_t> words(std::filesystem::file_size(path) / sizeof(uint32_t));
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+    return words;
+}
+
+static void write_words(const std::filesystem::path& path, const std::vector<uint32_t>& words) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+}
+
+// replaces a word of the cache and seals it with a matching checksum, so that only the validation can reject it
+static void forge_word(const std::filesystem::path& path, const size_t index, const uint32_t value) {
+    std::vector<uint32_t> words = read_words(path);
+    words.resize(words.size() - 2);
+    words[index] = value;
+    PolyhedronCache::Hasher hasher;
+    hasher.add(words.data(), words.size() * sizeof(uint32_t));
+    words.push_back(static_cast<uint32_t>(hasher.hash()));
+    words.push_back(static_cast<uint32_t>(hasher.hash() >> 32));
+    write_words(path, words);
+}
+
+static void require_same(const Polyhedron<CacheInterval>& polyhedron, const Polyhedron<CacheInterval>& other_polyhedron) {
+    REQUIRE(polyhedron.faces() == other_polyhedron.faces());
+    REQUIRE(polyhedron.outlines().size() == other_polyhedron.outlines().size());
+    for(size_t i = 0; i < polyhedron.outlines().size(); ++i) {
+        REQUIRE(polyhedron.outlines()[i].normal_mask == other_polyhedron.outlines()[i].normal_mask);
+        REQUIRE(polyhedron.outlines()[i].vertex_indices == other_polyhedron.outlines()[i].vertex_indices);
+    }
+    REQUIRE(polyhedron.rotations().size() == other_polyhedron.rotations().size());
+    REQUIRE(polyhedron.reflections().size() == other_polyhedron.reflections().size());
+}
+
+TEST_CASE("polyhedron") {
+    SECTION("coinciding vertices are rejected") {
+        std::vector<Vector3<CacheInterval>> vertices = Platonic::cube<CacheInterval>();
+        vertices.push_back(vertices.front());
+        REQUIRE_THROWS_AS(Polyhedron<CacheInterval>(vertices), std::runtime_error);
+    }
+}
+
+TEST_CASE("gauss map") {
+    const Polyhedron<CacheInterval> cube(Platonic::cube<CacheInterval>());
+    const std::vector<Vector3<CacheInterval>>& normals = cube.face_normals();
+    const GaussMap<CacheInterval> gauss_map(normals);
+
+    const auto faces_in_front = [&](const Vector3<CacheInterval>& direction) {
+        NormalMask normal_mask;
+        for(size_t index = 0; index < normals.size(); ++index) {
+            if(direction.dot(normals[index]).pos()) {
+                normal_mask.set(index);
+            }
+        }
+        return normal_mask;
+    };
+
+    const auto ratio = [](const int numerator, const int denominator) {
+        return CacheInterval(numerator) / CacheInterval(denominator);
+    };
+
+    // the direction with the given coordinates across the cube face of the axis and sign
+    const auto direction = [](const size_t axis, const int sign, const CacheInterval& u, const CacheInterval& v) {
+        const CacheInterval w(sign);
+        return axis == 0 ? Vector3<CacheInterval>(w, u, v) : axis == 1 ? Vector3<CacheInterval>(v, w, u) : Vector3<CacheInterval>(u, v, w);
+    };
+
+    SECTION("cells give the faces in front") {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            for(const int sign: {-1, 1}) {
+                for(const auto& [u, v]: {std::pair(30, 20), std::pair(-55, 70), std::pair(90, -95)}) {
+                    const Vector3<CacheInterval> cell_direction = direction(axis, sign, ratio(u, 100), ratio(v, 100));
+                    const std::optional<NormalMask> normal_mask = gauss_map.get_normal_mask(cell_direction, normals);
+                    REQUIRE(normal_mask.has_value());
+                    REQUIRE(normal_mask.value() == faces_in_front(cell_direction));
+                    REQUIRE(normal_mask.value().count() == 3);
+                }
+            }
+        }
+    }
+
+    SECTION("directions next to cell borders give the faces in front") {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            for(const int sign: {-1, 1}) {
+                for(int k = 1; k < 16; ++k) {
+                    const CacheInterval border = ratio(k - 8, 8);
+                    for(const int offset: {-1, 1}) {
+                        const Vector3<CacheInterval> border_direction = direction(axis, sign, border + ratio(offset, 1000000000), ratio(3, 10));
+                        const std::optional<NormalMask> normal_mask = gauss_map.get_normal_mask(border_direction, normals);
+                        REQUIRE(normal_mask.has_value());
+                        REQUIRE(normal_mask.value() == faces_in_front(border_direction));
+                    }
+                    // a cone across the border is looked up in the cells on both sides
+                    const Vector3<CacheInterval> cone = direction(axis, sign, (border - ratio(1, 1000)).hull(border + ratio(1, 1000)), ratio(-3, 10));
+                    const std::optional<NormalMask> normal_mask = gauss_map.get_normal_mask(cone, normals);
+                    if(k == 8) {
+                        // the cone holds directions perpendicular to a face normal
+                        REQUIRE((!normal_mask.has_value() || normal_mask.value().none()));
+                    } else {
+                        REQUIRE(normal_mask.has_value());
+                        REQUIRE(normal_mask.value() == faces_in_front(cone));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("directions on a cell border or across many cells are left to the caller") {
+        REQUIRE_FALSE(gauss_map.get_normal_mask(direction(0, 1, ratio(1, 4), ratio(3, 10)), normals).has_value());
+        REQUIRE_FALSE(gauss_map.get_normal_mask(direction(0, 1, CacheInterval(-1, 1) / CacheInterval(2), ratio(3, 10)), normals).has_value());
+        REQUIRE(cube.get_normal_mask(direction(0, 1, ratio(3, 10), CacheInterval(0))).none());
+    }
+
+    SECTION("cells give the outline masks") {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            for(const int sign: {-1, 1}) {
+                const Vector3<CacheInterval> cell_direction = direction(axis, sign, ratio(3, 10), ratio(-2, 10));
+                const std::optional<size_t> outline_index = cube.find_outline(cube.get_normal_mask(cell_direction));
+                REQUIRE(outline_index.has_value());
+                REQUIRE(cube.outlines()[outline_index.value()].normal_mask == faces_in_front(cell_direction));
+                REQUIRE(cube.outlines()[outline_index.value()].vertex_indices.size() == 6);
+            }
+        }
+    }
+}
+
+TEST_CASE("polyhedron cache") {
+    const std::filesystem::path cache_directory = std::filesystem::temp_directory_path() / "polyhedron_cache_test";
+    std::filesystem::remove_all(cache_directory);
+
+    const Polyhedron<CacheInterval> polyhedron(Platonic::cube<CacheInterval>());
+    const Polyhedron<CacheInterval> written_polyhedron(Platonic::cube<CacheInterval>(), cache_directory);
+    require_same(written_polyhedron, polyhedron);
+    REQUIRE(std::distance(std::filesystem::directory_iterator(cache_directory), std::filesystem::directory_iterator()) == 1);
+    const std::filesystem::path path = std::filesystem::directory_iterator(cache_directory)->path();
+    const std::vector<uint32_t> words = read_words(path);
+
+    // magic, version and key, then the faces, then the outlines with their normal masks
+    const size_t first_face_word = 6;
+    size_t first_outline_word = 5;
+    for(const std::vector<size_t>& face: polyhedron.faces()) {
+        first_outline_word += 1 + face.size();
+    }
+    first_outline_word += 3 + polyhedron.outlines()[0].normal_mask.count();
+
+    // then the permutations of the vertices by the rotations and the reflections, then the rotations and the reflections
+    // of every outline
+    size_t rotation_count_word = first_outline_word - 2 - polyhedron.outlines()[0].normal_mask.count();
+    for(const Outline& outline: polyhedron.outlines()) {
+        rotation_count_word += 2 + outline.normal_mask.count() + outline.vertex_indices.size();
+    }
+    const size_t first_rotation_word = rotation_count_word + 2;
+    const size_t vertex_count = polyhedron.vertices().size();
+    const size_t first_outline_rotation_word = rotation_count_word + 3 + (polyhedron.rotations().size() + polyhedron.reflections().size()) * (1 + vertex_count);
+
+    const auto vertex_not_in = [&](const std::vector<size_t>& vertex_indices) {
+        size_t vertex_index = 0;
+        while(std::ranges::find(vertex_indices, vertex_index) != vertex_indices.end()) {
+            vertex_index++;
+        }
+        return static_cast<uint32_t>(vertex_index);
+    };
+
+    SECTION("round trip") {
+        require_same(Polyhedron<CacheInterval>(Platonic::cube<CacheInterval>(), cache_directory), polyhedron);
+        REQUIRE(read_words(path) == words);
+    }
+
+    SECTION("corrupted cache is rewritten") {
+        std::vector<uint32_t> corrupted_words = words;
+        corrupted_words[first_face_word] ^= 1;
+        write_words(path, corrupted_words);
+        require_same(Polyhedron<CacheInterval>(Platonic::cube<CacheInterval>(), cache_directory), polyhedron);
+        REQUIRE(read_words(path) == words);
+    }
+
+    SECTION("forged face is rejected") {
+        forge_word(path, first_face_word, vertex_not_in(polyhedron.faces()[0]));
+        require_same(Polyhedron<CacheInterval>(Platonic::cube<CacheInterval>(), cache_directory), polyhedron);
+        REQUIRE(read_words(path) == words);
+    }
+
+    SECTION("forged outline is rejected") {
+        forge_word(path, first_outline_word, vertex_not_in(polyhedron.outlines()[0].vertex_indices));
+        require_same(Polyhedron<CacheInterval>(Platonic::cube<CacheInterval>(), cache_directory), polyhedron);
+        REQUIRE(read_words(path) == words);
+    }
+
+    SECTION("forged symmetry is rejected") {
+        forge_word(path, first_rotation_word, words[first_rotation_word + 1]);
+        require_same(Polyhedron<CacheInterval>(Platonic::cube<CacheInterval>(), cache_directory), polyhedron);
+        REQUIRE(read_words(path) == words);
+    }
+
+    SECTION("forged outline symmetry is rejected") {
+        REQUIRE(words[first_outline_rotation_word - 1] > 1);
+        forge_word(path, first_outline_rotation_word, words[first_outline_rotation_word + 1]);
+        require_same(Polyhedron<CacheInterval>(Platonic::cube<CacheInterval>(), cache_directory), polyhedron);
+        REQUIRE(read_words(path) == words);
+    }
+
+    std::filesystem::remove_all(cache_directory);
+}
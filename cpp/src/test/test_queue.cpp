@@ -0,0 +1,109 @@
+#include "queue/queues.hpp"
+#include "box/boxes.hpp"
+#include <catch2/catch_all.hpp>
+
+static_assert(QueueType<ConcurrentBucketQueue<Box3>, Box3>);
+static_assert(QueueType<ConcurrentBucketStack<Box3>, Box3>);
+
+struct DepthTask {
+    size_t level;
+    int id;
+
+    size_t depth() const {
+        return level;
+    }
+};
+
+TEST_CASE("bucket queue") {
+    SECTION("empty") {
+        ConcurrentBucketQueue<DepthTask> queue;
+        REQUIRE(queue.size() == 0);
+        REQUIRE_FALSE(queue.fetch().has_value());
+    }
+
+    SECTION("shallowest first, fifo within depth") {
+        ConcurrentBucketQueue<DepthTask> queue;
+        queue.add(DepthTask{2, 0});
+        queue.add(DepthTask{1, 1});
+        queue.add(DepthTask{2, 2});
+        queue.add(DepthTask{1, 3});
+        std::vector<int> ids;
+        while(const std::optional<DepthTask> task = queue.fetch()) {
+            ids.push_back(task->id);
+        }
+        REQUIRE(ids == std::vector{1, 3, 0, 2});
+    }
+
+    SECTION("shallowest first, lifo within depth") {
+        ConcurrentBucketStack<DepthTask> queue;
+        queue.add(DepthTask{2, 0});
+        queue.add(DepthTask{1, 1});
+        queue.add(DepthTask{2, 2});
+        queue.add(DepthTask{1, 3});
+        std::vector<int> ids;
+        while(const std::optional<DepthTask> task = queue.fetch()) {
+            ids.push_back(task->id);
+        }
+        REQUIRE(ids == std::vector{3, 1, 2, 0});
+    }
+
+    SECTION("shallower task added after fetch") {
+        ConcurrentBucketQueue<DepthTask> queue;
+        queue.add(DepthTask{3, 0});
+        REQUIRE(queue.fetch()->id == 0);
+        queue.add(DepthTask{5, 1});
+        queue.add(DepthTask{4, 2});
+        REQUIRE(queue.fetch()->id == 2);
+        queue.add(DepthTask{0, 3});
+        REQUIRE(queue.fetch()->id == 3);
+        REQUIRE(queue.fetch()->id == 1);
+    }
+
+    SECTION("size counts unacknowledged tasks") {
+        ConcurrentBucketQueue<DepthTask> queue;
+        queue.add(DepthTask{0, 0});
+        queue.add(DepthTask{1, 1});
+        REQUIRE(queue.size() == 2);
+        REQUIRE(queue.fetch().has_value());
+        REQUIRE(queue.size() == 2);
+        queue.ack();
+        REQUIRE(queue.size() == 1);
+        REQUIRE(queue.flush().size() == 1);
+        REQUIRE(queue.size() == 0);
+    }
+
+    SECTION("box depth") {
+        const Box3 box(std::array{Range(Bitset(0, 0)), Range(Bitset(1, 0)), Range(Bitset(1, 0))});
+        REQUIRE(box.depth() == 2);
+        for(const Box3& part: box.parts()) {
+            REQUIRE(part.depth() == 5);
+        }
+    }
+}
+
+TEST_CASE("serial queue") {
+    SECTION("queue is fifo") {
+        SerialQueue<int> queue;
+        for(const int task: {0, 1, 2}) {
+            queue.add(task);
+        }
+        REQUIRE(queue.fetch() == 0);
+        queue.ack();
+        REQUIRE(queue.size() == 2);
+        REQUIRE(queue.flush() == std::vector{1, 2});
+        REQUIRE(queue.size() == 0);
+    }
+
+    SECTION("stack is lifo") {
+        SerialStack<int> stack;
+        for(const int task: {0, 1, 2}) {
+            stack.add(task);
+        }
+        REQUIRE(stack.fetch() == 2);
+        stack.ack();
+        stack.add(3);
+        REQUIRE(stack.size() == 3);
+        REQUIRE(stack.flush() == std::vector{3, 1, 0});
+        REQUIRE_FALSE(stack.fetch().has_value());
+    }
+}